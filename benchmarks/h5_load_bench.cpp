@@ -0,0 +1,97 @@
+#include <hydroc/h5fileinfo.h>
+#include <hydroc/helper.h>
+#include <hydroc/hydro_database.h>
+
+#include <algorithm>
+#include <chrono>      // std::chrono::high_resolution_clock::now
+#include <filesystem>  // C++17
+#include <iomanip>     // std::setprecision
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Startup cost of reading the bundled h5 files into HydroData.
+//
+// usage: ./h5_load_bench DATADIR [NUM_RUNS]
+//
+// Times H5FileInfo::ReadH5Data() on f3of.h5 (3 bodies) and rm3.h5 (2 bodies), on one thread and with the bodies read
+// in parallel (see H5FileInfo::SetNumThreads()), then HydroDatabase::Read() on the hydro databases converted from them
+// (written to the temporary directory), best of NUM_RUNS (default 5) runs. The slowest datasets of the last parallel
+// read of each file follow (see H5FileInfo::GetDatasetTimings()).
+//
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+    const int num_runs = argc > 2 ? std::stoi(argv[2]) : 5;
+
+    std::filesystem::path DATADIR(hydroc::getDataDir());
+
+    struct Model {
+        std::string name;
+        std::string h5fname;
+        int num_bodies;
+    };
+    const std::vector<Model> models = {
+        {"f3of", (DATADIR / "f3of" / "hydroData" / "f3of.h5").lexically_normal().generic_string(), 3},
+        {"rm3", (DATADIR / "rm3" / "hydroData" / "rm3.h5").lexically_normal().generic_string(), 2}};
+
+    std::vector<std::vector<H5DatasetTiming>> timings;
+    std::cout << "model  file [MB]  read [ms]  parallel read [ms]  database [MB]  database read [ms]" << std::endl;
+    for (const auto& model : models) {
+        double best = 1e300;
+        for (int run = 0; run < num_runs; run++) {
+            auto start      = std::chrono::high_resolution_clock::now();
+            HydroData infos = H5FileInfo(model.h5fname, model.num_bodies).ReadH5Data();
+            auto end        = std::chrono::high_resolution_clock::now();
+            best            = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+        }
+
+        double best_parallel = 1e300;
+        for (int run = 0; run < num_runs; run++) {
+            H5FileInfo file_info(model.h5fname, model.num_bodies);
+            file_info.SetNumThreads(0);
+            auto start      = std::chrono::high_resolution_clock::now();
+            HydroData infos = file_info.ReadH5Data();
+            auto end        = std::chrono::high_resolution_clock::now();
+            best_parallel   = std::min(best_parallel, std::chrono::duration<double, std::milli>(end - start).count());
+            if (run == num_runs - 1) {
+                timings.push_back(file_info.GetDatasetTimings());
+            }
+        }
+
+        const auto db_fname =
+            (std::filesystem::temp_directory_path() / (model.name + "_bench.hydrodb")).generic_string();
+        HydroDatabase::Write(db_fname, H5FileInfo(model.h5fname, model.num_bodies).ReadH5Data());
+        double best_db = 1e300;
+        for (int run = 0; run < num_runs; run++) {
+            auto start      = std::chrono::high_resolution_clock::now();
+            HydroData infos = HydroDatabase::Read(db_fname, model.num_bodies);
+            auto end        = std::chrono::high_resolution_clock::now();
+            best_db         = std::min(best_db, std::chrono::duration<double, std::milli>(end - start).count());
+        }
+
+        const double size_mb    = std::filesystem::file_size(model.h5fname) / 1e6;
+        const double db_size_mb = std::filesystem::file_size(db_fname) / 1e6;
+        std::filesystem::remove(db_fname);
+        std::cout << std::left << std::setw(5) << model.name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(11) << size_mb << std::setw(11) << std::setprecision(2) << best << std::setw(20)
+                  << best_parallel << std::setw(15) << std::setprecision(1) << db_size_mb << std::setw(20)
+                  << std::setprecision(3) << best_db << std::endl;
+    }
+
+    std::cout << std::endl << "slowest datasets  read [ms]  process [ms]  values" << std::endl;
+    for (size_t m = 0; m < models.size(); m++) {
+        auto& model_timings = timings[m];
+        std::sort(model_timings.begin(), model_timings.end(), [](const auto& a, const auto& b) {
+            return a.read_ms + a.process_ms > b.read_ms + b.process_ms;
+        });
+        model_timings.resize(std::min<size_t>(model_timings.size(), 5));
+        for (const auto& timing : model_timings) {
+            std::cout << models[m].name << ": " << timing.name << std::endl
+                      << std::fixed << std::setprecision(3) << std::setw(28) << timing.read_ms << std::setw(14)
+                      << timing.process_ms << std::setw(8) << timing.num_values << std::endl;
+        }
+    }
+    return 0;
+}
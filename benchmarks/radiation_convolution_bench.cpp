@@ -0,0 +1,64 @@
+#include <hydroc/radiation_convolution.h>
+
+#include <algorithm>
+#include <chrono>  // std::chrono::high_resolution_clock::now
+#include <cmath>
+#include <iomanip>  // std::setprecision
+#include <iostream>
+#include <string>
+
+// Scaling of the direct radiation convolution with the number of threads.
+//
+// usage: ./radiation_convolution_bench [NUM_BODIES] [RIRF_STEPS] [MAX_THREADS] [NUM_STEPS]
+//
+// Defaults to a 20 body array with 1000 RIRF steps (14400 kernels), timed from 1 thread up to the OpenMP default.
+//
+int main(int argc, char* argv[]) {
+    const int num_bodies  = argc > 1 ? std::stoi(argv[1]) : 20;
+    const int size        = argc > 2 ? std::stoi(argv[2]) : 1000;
+    const int max_threads = argc > 3 ? std::stoi(argv[3]) : GetRadiationNumThreads(0);
+    const int num_steps   = argc > 4 ? std::stoi(argv[4]) : 20;
+    const int num_dofs    = 6 * num_bodies;
+
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> kernel(num_dofs, num_dofs * size);
+    for (int row = 0; row < num_dofs; row++) {
+        for (int col = 0; col < num_dofs; col++) {
+            for (int step = 0; step < size; step++) {
+                kernel(row, col * size + step) = std::exp(-0.01 * step) * std::cos(0.05 * step + row - col);
+            }
+        }
+    }
+    Eigen::MatrixXd velocities = Eigen::MatrixXd::Random(size, num_dofs);
+    Eigen::VectorXd force(num_dofs);
+
+    std::cout << num_bodies << " bodies, " << size << " RIRF steps, " << num_steps << " steps per run" << std::endl;
+    std::cout << "threads  time/step [ms]  speedup  efficiency" << std::endl;
+
+    double serial_time = 0.0;
+    for (int num_threads = 1; num_threads <= max_threads; num_threads++) {
+        // warm up, then keep the best of a few runs
+        force.setZero();
+        AddRadiationConvolution(kernel, size, velocities, {}, force, num_threads);
+        double best = 1e300;
+        for (int run = 0; run < 3; run++) {
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int step = 0; step < num_steps; step++) {
+                force.setZero();
+                AddRadiationConvolution(kernel, size, velocities, {}, force, num_threads);
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            best     = std::min(best, std::chrono::duration<double, std::milli>(end - start).count() / num_steps);
+        }
+        if (num_threads == 1) {
+            serial_time = best;
+        }
+        const double speedup = serial_time / best;
+        std::cout << std::setw(7) << num_threads << std::setw(16) << std::fixed << std::setprecision(3) << best
+                  << std::setw(9) << std::setprecision(2) << speedup << std::setw(12) << speedup / num_threads
+                  << std::endl;
+    }
+
+    // keeps the result alive
+    std::cout << "checksum " << std::setprecision(6) << force.sum() << std::endl;
+    return 0;
+}
@@ -0,0 +1,181 @@
+#include <hydroc/helper.h>
+#include <hydroc/hydro_forces.h>
+
+#include <chrono/physics/ChLinkRSDA.h>
+#include <chrono/physics/ChLinkTSDA.h>
+#include <chrono/physics/ChLinkLock.h>
+#include <chrono/physics/ChSystemNSC.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>  // C++17
+#include <functional>
+#include <iomanip>  // std::setprecision
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Largest stable HHT time step of the sphere, RM3 and DeepCWind decay tests: all hydro forces explicit, implicit
+// hydrostatics (see TestHydro::SetImplicitHydrostatics()), then implicit hydrostatics and instantaneous radiation
+// damping (see TestHydro::SetImplicitRadiation()).
+//
+// usage: ./stable_timestep_bench DATADIR [MODEL]
+//
+// MODEL is sphere, rm3 or deepcwind, all models by default. The time step grows by 25% from 0.01 s until the decay
+// test becomes unstable: non finite positions, or an oscillation larger in the last quarter of the run than in the
+// first quarter.
+
+namespace {
+struct DecayModel {
+    std::string name;
+    double duration;
+    // builds the model in the system, returns the monitored coordinate (heave or pitch) of the decaying body
+    std::function<std::function<double()>(ChSystem&, std::unique_ptr<TestHydro>&)> build;
+};
+
+void SetUpSystem(ChSystem& system, double timestep) {
+    system.Set_G_acc(ChVector<>(0.0, 0.0, -9.81));
+    system.SetTimestepperType(ChTimestepper::Type::HHT);
+    system.SetSolverType(ChSolver::Type::GMRES);
+    system.SetSolverMaxIterations(300);
+    system.SetStep(timestep);
+}
+
+std::shared_ptr<ChBody> AddBody(ChSystem& system,
+                                const std::string& name,
+                                const ChVector<>& position,
+                                double mass,
+                                const ChVector<>& inertia) {
+    auto body = chrono_types::make_shared<ChBody>();
+    system.Add(body);
+    body->SetNameString(name);
+    body->SetPos(position);
+    body->SetMass(mass);
+    body->SetInertiaXX(inertia);
+    return body;
+}
+
+// same bodies and initial conditions as the decay demos
+std::vector<DecayModel> CreateModels(const std::filesystem::path& data_dir) {
+    std::vector<DecayModel> models;
+
+    const auto sphere_h5 = (data_dir / "sphere" / "hydroData" / "sphere.h5").lexically_normal().generic_string();
+    models.push_back({"sphere", 40.0, [sphere_h5](ChSystem& system, std::unique_ptr<TestHydro>& hydro) {
+                          auto sphere = AddBody(system, "body1", ChVector<>(0, 0, -1), 261.8e3,
+                                                ChVector<>(1.6e6, 1.6e6, 1.6e6));
+                          hydro       = std::make_unique<TestHydro>(std::vector<std::shared_ptr<ChBody>>{sphere},
+                                                              sphere_h5);
+                          return std::function<double()>([sphere]() { return sphere->GetPos().z(); });
+                      }});
+
+    const auto rm3_h5 = (data_dir / "rm3" / "hydroData" / "rm3.h5").lexically_normal().generic_string();
+    models.push_back({"rm3", 40.0, [rm3_h5](ChSystem& system, std::unique_ptr<TestHydro>& hydro) {
+                          auto float_body = AddBody(system, "body1", ChVector<>(0, 0, -0.72 + 0.1), 725834,
+                                                    ChVector<>(20907301.0, 21306090.66, 37085481.11));
+                          auto plate_body = AddBody(system, "body2", ChVector<>(0, 0, -21.29), 886691,
+                                                    ChVector<>(94419614.57, 94407091.24, 28542224.82));
+                          auto prismatic = chrono_types::make_shared<ChLinkLockPrismatic>();
+                          prismatic->Initialize(float_body, plate_body, false, ChCoordsys<>(ChVector<>(0, 0, -0.72)),
+                                                ChCoordsys<>(ChVector<>(0, 0, -21.29)));
+                          system.AddLink(prismatic);
+                          auto pto = chrono_types::make_shared<ChLinkTSDA>();
+                          pto->Initialize(float_body, plate_body, false, ChVector<>(0, 0, -0.72),
+                                          ChVector<>(0, 0, -21.29));
+                          pto->SetDampingCoefficient(0.0);
+                          system.AddLink(pto);
+                          hydro = std::make_unique<TestHydro>(
+                              std::vector<std::shared_ptr<ChBody>>{float_body, plate_body}, rm3_h5);
+                          return std::function<double()>([float_body]() { return float_body->GetPos().z(); });
+                      }});
+
+    const auto deepcwind_h5 =
+        (data_dir / "DeepCWind" / "hydroData" / "deepcwind.h5").lexically_normal().generic_string();
+    models.push_back({"deepcwind", 400.0, [deepcwind_h5](ChSystem& system, std::unique_ptr<TestHydro>& hydro) {
+                          const auto cg = ChVector<>(0.0, 0.0, -7.53);
+                          auto base     = AddBody(system, "body1", cg, 1.419625e7,
+                                                  ChVector<>(1.2898e10, 1.2851e10, 1.4189e10));
+                          base->SetRot(Q_from_AngAxis(-3.95 * CH_C_PI / 180.0, VECT_Y));
+                          auto ground = chrono_types::make_shared<ChBody>();
+                          system.AddBody(ground);
+                          ground->SetPos(cg);
+                          ground->SetBodyFixed(true);
+                          ground->SetCollide(false);
+                          auto rot_damp = chrono_types::make_shared<ChLinkRSDA>();
+                          rot_damp->SetDampingCoefficient(31e6);
+                          const ChQuaternion<> rev_rot = Q_from_AngAxis(CH_C_PI / 2.0, VECT_X);
+                          rot_damp->Initialize(base, ground, false, ChCoordsys(cg, rev_rot), ChCoordsys(cg, rev_rot));
+                          system.AddLink(rot_damp);
+                          hydro = std::make_unique<TestHydro>(std::vector<std::shared_ptr<ChBody>>{base}, deepcwind_h5);
+                          return std::function<double()>([base]() { return base->GetRot().Q_to_Euler123().y(); });
+                      }});
+
+    return models;
+}
+
+// runs the decay test, stable if the oscillation decays
+bool IsStable(const DecayModel& model, double timestep, bool implicit_hydrostatics, bool implicit_radiation) {
+    ChSystemNSC system;
+    SetUpSystem(system, timestep);
+    std::unique_ptr<TestHydro> hydro;
+    auto coordinate = model.build(system, hydro);
+    hydro->SetImplicitHydrostatics(implicit_hydrostatics);
+    hydro->SetImplicitRadiation(implicit_radiation);
+
+    const double initial = coordinate();
+    const int num_steps  = static_cast<int>(std::ceil(model.duration / timestep));
+    double first_quarter = 0.0;
+    double last_quarter  = 0.0;
+    try {
+        for (int step = 0; step < num_steps; step++) {
+            system.DoStepDynamics(timestep);
+            const double value = coordinate();
+            if (!std::isfinite(value)) {
+                return false;
+            }
+            const double deviation = std::abs(value - initial);
+            if (step < num_steps / 4) {
+                first_quarter = std::max(first_quarter, deviation);
+            } else if (step >= num_steps - num_steps / 4) {
+                last_quarter = std::max(last_quarter, deviation);
+            }
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    return last_quarter <= first_quarter;
+}
+
+double LargestStableTimestep(const DecayModel& model, bool implicit_hydrostatics, bool implicit_radiation) {
+    double largest = 0.0;
+    for (double timestep = 0.01; timestep < 5.0; timestep *= 1.25) {
+        if (!IsStable(model, timestep, implicit_hydrostatics, implicit_radiation)) {
+            break;
+        }
+        largest = timestep;
+    }
+    return largest;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+    const std::string selected = argc > 2 ? argv[2] : "";
+
+    std::cout << "model       explicit dt [s]  hydrostatics dt [s]  + radiation dt [s]  ratio" << std::endl;
+    for (const auto& model : CreateModels(hydroc::getDataDir())) {
+        if (!selected.empty() && selected != model.name) {
+            continue;
+        }
+        const double explicit_dt     = LargestStableTimestep(model, false, false);
+        const double hydrostatics_dt = LargestStableTimestep(model, true, false);
+        const double implicit_dt     = LargestStableTimestep(model, true, true);
+        std::cout << std::left << std::setw(12) << model.name << std::right << std::fixed << std::setprecision(4)
+                  << std::setw(15) << explicit_dt << std::setw(21) << hydrostatics_dt << std::setw(20) << implicit_dt
+                  << std::setw(7) << std::setprecision(2) << (explicit_dt > 0.0 ? implicit_dt / explicit_dt : 0.0)
+                  << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+#ifndef BINARY_CACHE_H
+#define BINARY_CACHE_H
+/*********************************************************************
+ * @file  binary_cache.h
+ *
+ * @brief header file for the content addressed binary cache of \
+ * preprocessed results (keys and cache files).
+ *********************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <Eigen/Dense>
+
+/**
+ * @brief 64 bit key of the inputs of a computation (FNV-1a hash), for content addressed cache files.
+ *
+ * Starts from the library version, so results cached by another version of HydroChrono are never reused.
+ */
+class CacheKey {
+  public:
+    CacheKey();
+
+    /**
+     * @brief Adds raw bytes to the key.
+     */
+    CacheKey& Add(const void* data, std::size_t size);
+
+    /**
+     * @brief Adds a string (its size and characters) to the key.
+     */
+    CacheKey& Add(const std::string& value);
+
+    /**
+     * @brief Adds a matrix or vector (its dimensions and values) to the key.
+     */
+    CacheKey& Add(const Eigen::Ref<const Eigen::MatrixXd>& value);
+
+    /**
+     * @brief Adds the contents of a file to the key.
+     *
+     * @param file_name file to read, throws std::runtime_error if it cannot be opened
+     */
+    CacheKey& AddFile(const std::string& file_name);
+
+    /**
+     * @brief Adds an arithmetic or enum value to the key.
+     */
+    template <typename T>
+    CacheKey& AddValue(T value) {
+        static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "CacheKey::AddValue takes plain values");
+        return Add(&value, sizeof(T));
+    }
+
+    /**
+     * @brief Gets the key.
+     */
+    std::uint64_t GetValue() const { return hash_; }
+
+    /**
+     * @brief Gets the key as 16 hexadecimal digits, for file names.
+     */
+    std::string GetHex() const;
+
+  private:
+    std::uint64_t hash_;
+};
+
+/**
+ * @brief Reads the matrices stored by WriteCacheFile() for a key.
+ *
+ * @param file_name cache file
+ * @param key expected key
+ * @param matrices filled with the stored matrices, unchanged if false is returned
+ *
+ * @return false if the file does not exist, was written for another key or format, or is incomplete
+ */
+bool ReadCacheFile(const std::string& file_name, std::uint64_t key, std::vector<Eigen::MatrixXd>& matrices);
+
+/**
+ * @brief Stores matrices in a cache file for a key, creating the directory if needed.
+ *
+ * The file is written under a temporary name and renamed when complete, so that concurrent runs never read a partial
+ * file. The cache is optional: failures are reported on std::cerr and otherwise ignored.
+ *
+ * @param file_name cache file
+ * @param key key of the inputs the matrices were computed from
+ * @param matrices matrices to store
+ */
+void WriteCacheFile(const std::string& file_name, std::uint64_t key, const std::vector<Eigen::MatrixXd>& matrices);
+
+#endif
@@ -24,14 +24,13 @@ class ChLoadAddedMass : public chrono::ChLoadCustomMultiple {
     /**
      * @brief Initializes body to have load applied to and added mass matrix from h5 file initialized object.
      *
-     * Vector of bodies with hydro forces (and added mass) need to be listed in same order as they are added to the
-     * system. Also need to be separate from any bodies without hydro forces (or added mass) and hydro bodies need to be
-     * added to system before any bodies without hydro forces applied.
+     * Vector of bodies with hydro forces (and added mass) need to be listed in the order of the h5 file. The 6N x 6N
+     * Jacobians are stamped at the state offsets of these bodies, so the system can hold any other bodies, added
+     * before or after them.
      *
      * @param body_info_struct HydroData::BodyInfo for each body with h5 information including added mass matrix
-     * @param bodies vector of Project Chrono bodies to apply added mass to. Must be added to system in same order as in
-     * this matrix.
-     * @param system pointer to system containing the bodies, used for getting system mass matrix size at any time.
+     * @param bodies vector of Project Chrono bodies to apply added mass to, in the order of the h5 file.
+     * @param system pointer to system containing the bodies, used for getting the gravity of the hydrostatic stiffness.
      */
     ChLoadAddedMass(const std::vector<HydroData::BodyInfo>& body_info_struct,
                     std::vector<std::shared_ptr<ChLoadable>>& bodies,
@@ -80,7 +79,8 @@ class ChLoadAddedMass : public chrono::ChLoadCustomMultiple {
      * inheritance.
      *
      * Note R here is vector, and is not R gyroscopic damping matrix from ComputeJacobian.
-     *  Just for efficiency, override the default LoadIntLoadResidual_Mv, because we can do this in a simplified way.
+     * Overrides the default LoadIntLoadResidual_Mv to gather w and scatter the product into preallocated vectors: only
+     * the 6N x 6N added mass block is multiplied, at the state offsets of the hydro bodies.
      *
      * @param R result: the R residual, R += c*M*w
      * @param w the w vector
@@ -88,11 +88,34 @@ class ChLoadAddedMass : public chrono::ChLoadCustomMultiple {
      */
     virtual void LoadIntLoadResidual_Mv(ChVectorDynamic<>& R, const ChVectorDynamic<>& w, const double c) override;
 
+    /**
+     * @brief Includes the hydrostatic stiffness rho g lin_matrix of each body in the K Jacobian.
+     *
+     * The implicit integrators then treat the hydrostatic restoring force implicitly, which allows larger time steps
+     * for stiff heave and pitch modes. g is the gravity of the system when the Jacobian is computed.
+     *
+     * @param rho water density, 0 removes the stiffness from the Jacobian
+     */
+    void SetHydrostaticStiffness(double rho) { hydrostatic_rho = rho; }
+
+    /**
+     * @brief Sets the instantaneous radiation damping of the bodies, included in the R Jacobian.
+     *
+     * The hydro force applies -damping * v with the current velocities v, so the implicit integrators treat this part
+     * of the radiation force implicitly.
+     *
+     * @param damping 6N x 6N damping matrix, empty for no damping
+     */
+    void SetRadiationDamping(const ChMatrixDynamic<double>& damping);
+
   private:
     ChSystem* system;
+    ChMatrixDynamic<double> linear_restoring;  ///< block diagonal lin_matrix of the bodies (unscaled)
+    double hydrostatic_rho = 0.0;              ///< scaling of linear_restoring by rho g in K, 0 for no stiffness
+    ChMatrixDynamic<double> radiation_damping;  ///< instantaneous radiation damping in R, empty for none
     ChMatrixDynamic<double> infinite_added_mass;  ///< added mass at infinite frequency in global coordinates
-    ChMatrixDynamic<double>
-        infinite_added_mass_system;  ///< added mass at infinite frequency in global coordinates (system matrix)
+    ChVectorDynamic<double> grouped_w;            ///< w at the hydro body offsets, for LoadIntLoadResidual_Mv
+    ChVectorDynamic<double> grouped_Mw;           ///< added mass times grouped_w
     virtual bool IsStiff() override { return true; }  // this to force the use of the inertial M, R and K matrices
 };
 
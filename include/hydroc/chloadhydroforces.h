@@ -0,0 +1,56 @@
+#ifndef CHLOADHYDROFORCES_H
+#define CHLOADHYDROFORCES_H
+/*********************************************************************
+ * @file  chloadhydroforces.h
+ *
+ * @brief header file for the hydro force chload class.
+ *********************************************************************/
+#pragma once
+
+#include <chrono/core/ChMatrix.h>
+#include <chrono/physics/ChLoad.h>
+
+#include <memory>
+#include <vector>
+
+using namespace chrono;
+
+class TestHydro;
+
+/**
+ * @brief Applies the 6N hydro wrench computed by TestHydro to the hydro bodies as one load.
+ *
+ * At each update, the body positions and velocities are read from the state vectors of the load, the total force is
+ * computed once by TestHydro::ComputeTotalForce(), and the forces (absolute frame) and torques (converted to the body
+ * frame, as Chrono expects) are written to load_Q. Replaces the six ChFunction components per body of ForceFunc6d.
+ */
+class ChLoadHydroForces : public chrono::ChLoadCustomMultiple {
+  public:
+    /**
+     * @brief Creates the load, it still has to be added to a ChLoadContainer of the system.
+     *
+     * @param hydro_forces TestHydro computing the forces, must outlive the load
+     * @param bodies hydro bodies, in the order of the h5 file
+     */
+    ChLoadHydroForces(TestHydro* hydro_forces, std::vector<std::shared_ptr<ChLoadable>>& bodies);
+
+    virtual ChLoadHydroForces* Clone() const override { return new ChLoadHydroForces(*this); }
+
+    /**
+     * @brief Computes the generalized hydro forces for the given states.
+     *
+     * @param state_x positions (position and rotation quaternion) of the bodies
+     * @param state_w velocities (linear velocity and angular velocity in the body frame) of the bodies
+     */
+    virtual void ComputeQ(ChState* state_x, ChStateDelta* state_w) override;
+
+  private:
+    TestHydro* hydro_forces_;
+    ChVectorDynamic<double> positions_;   ///< 6N positions and Euler123 rotations passed to TestHydro
+    ChVectorDynamic<double> velocities_;  ///< 6N linear and angular velocities in the absolute frame
+
+    // the force is explicit, no Jacobian is computed
+    virtual bool IsStiff() override { return false; }
+};
+
+#endif
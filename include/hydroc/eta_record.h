@@ -0,0 +1,106 @@
+#ifndef ETA_RECORD_H
+#define ETA_RECORD_H
+/*********************************************************************
+ * @file  eta_record.h
+ *
+ * @brief header file for measured free surface elevation records, \
+ * read from text files or memory mapped binary files.
+ *********************************************************************/
+#pragma once
+
+#include <hydroc/mapped_file.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Free surface elevation record, the samples of an eta file.
+ *
+ * Two file formats are read:
+ * - text, one "time : eta" line per sample (the format written by IrregularWaves);
+ * - binary, a header with the start time, time step and number of samples, followed by the elevations as float64 or
+ *   float32 values (see WriteBinary()). The file is memory mapped and the elevations are used in place, without a
+ *   copy.
+ *
+ * The times must be strictly increasing. Records sampled at a uniform time step (always the case for binary files) are
+ * interpolated by direct indexing, the others by a binary search.
+ */
+class EtaRecord {
+  public:
+    EtaRecord() = default;
+
+    /**
+     * @brief Reads a record, in the binary format if the file starts with its header, as text otherwise.
+     *
+     * @param file_name eta file
+     *
+     * @return the record, throws std::runtime_error if the file cannot be read or parsed, or if the times are not
+     * strictly increasing
+     */
+    static EtaRecord Read(const std::string& file_name);
+
+    /**
+     * @brief Writes a uniformly sampled record in the binary format.
+     *
+     * @param file_name eta file to write, throws std::runtime_error on failure
+     * @param start_time time of the first sample
+     * @param time_step time between samples
+     * @param elevations samples
+     * @param single_precision store float32 instead of float64 values
+     */
+    static void WriteBinary(const std::string& file_name,
+                            double start_time,
+                            double time_step,
+                            const std::vector<double>& elevations,
+                            bool single_precision = false);
+
+    /**
+     * @brief Gets the number of samples.
+     */
+    std::size_t GetSize() const { return size_; }
+
+    /**
+     * @brief Gets the time of sample i.
+     */
+    double GetTime(std::size_t i) const { return times_ ? (*times_)[i] : start_time_ + i * time_step_; }
+
+    /**
+     * @brief Gets the elevation of sample i.
+     */
+    double GetElevation(std::size_t i) const { return single_values_ ? single_values_[i] : double_values_[i]; }
+
+    /**
+     * @brief Checks if the samples are at a uniform time step (relative deviation below 1e-6 of the step).
+     */
+    bool IsUniform() const { return uniform_; }
+
+    /**
+     * @brief Checks if the elevations are used in place from a memory mapped file.
+     */
+    bool IsMapped() const { return mapped_; }
+
+    /**
+     * @brief Gets the elevation at time t, interpolated linearly, zero outside of the record.
+     *
+     * The zero elevation pads the record for the excitation IRF near its ends, IrregularWaves throws for simulation
+     * times outside of the record.
+     */
+    double GetElevationAt(double t) const;
+
+  private:
+    std::shared_ptr<const void> storage_;               ///< mapped file or parsed values, owns the samples
+    std::shared_ptr<const std::vector<double>> times_;  ///< parsed times, null for binary records
+    const double* double_values_ = nullptr;
+    const float* single_values_  = nullptr;
+    std::size_t size_            = 0;
+    bool uniform_                = false;
+    bool mapped_                 = false;
+    double start_time_           = 0.0;
+    double time_step_            = 0.0;
+
+    void DetectUniformSpacing();
+};
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef FREE_SURFACE_GENERATOR_H
+#define FREE_SURFACE_GENERATOR_H
+/*********************************************************************
+ * @file  free_surface_generator.h
+ *
+ * @brief header file for the on demand generation of the irregular \
+ * wave free surface elevation, in chunks of bounded size.
+ *********************************************************************/
+#pragma once
+
+#include <hydroc/harmonic_synthesis.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <Eigen/Dense>
+
+/**
+ * @brief Generates the free surface elevation of an irregular wave on the uniform time grid t_n = n dt.
+ *
+ * eta(t_n) = ramp(t_n) sum_k A_k cos(omega_k t_n + phase_k), with ramp(t) = min(max(t / ramp_duration, 0), 1), or 1
+ * without a ramp. Samples are generated on demand for any range of n (negative n are times before the start of the
+ * simulation), so the memory does not depend on the simulation duration.
+ *
+ * Uniformly spaced frequencies, as from the spectra of IrregularWaves, are summed with FFTs by HarmonicSynthesis, in
+ * O(log K) per sample for K components. Otherwise, within a chunk, the components are advanced with the phasor
+ * recurrence z_k(t + dt) = z_k(t) exp(i omega_k dt), one complex multiplication per component and sample instead of a
+ * cosine. The phasors are evaluated exactly at the start of every chunk, so the round-off does not accumulate over the
+ * simulation.
+ */
+class FreeSurfaceElevationGenerator {
+  public:
+    FreeSurfaceElevationGenerator() = default;
+
+    /**
+     * @brief Sets up the components and the time grid.
+     *
+     * @param amplitudes amplitude A_k of each component
+     * @param omegas frequency omega_k of each component [rad/s]
+     * @param phases phase of each component [rad]
+     * @param dt time step of the grid
+     * @param ramp_duration duration of the linear ramp from t = 0, 0 for no ramp
+     * @param chunk_size number of samples generated from one exact evaluation of the phasors, also the read ahead
+     * of FreeSurfaceElevationWindow
+     */
+    FreeSurfaceElevationGenerator(const std::vector<double>& amplitudes,
+                                  const std::vector<double>& omegas,
+                                  const std::vector<double>& phases,
+                                  double dt,
+                                  double ramp_duration,
+                                  int chunk_size = 1024);
+
+    /**
+     * @brief Computes the samples first,...,first + count - 1. Can be called concurrently.
+     *
+     * @param first index of the first sample
+     * @param count number of samples
+     * @param eta count values, filled with the samples
+     */
+    void Generate(std::int64_t first, int count, double* eta) const;
+
+    /**
+     * @brief Gets the time step of the grid.
+     */
+    double GetTimeStep() const { return dt_; }
+
+    /**
+     * @brief Gets the number of samples generated from one exact evaluation of the phasors (and read ahead).
+     */
+    int GetChunkSize() const { return chunk_size_; }
+
+  private:
+    double dt_            = 0.0;
+    double ramp_duration_ = 0.0;
+    int chunk_size_       = 1024;
+    Eigen::ArrayXd amplitudes_;
+    Eigen::ArrayXd omegas_;
+    Eigen::ArrayXd phases_;
+    Eigen::ArrayXd rotation_re_;  ///< cos(omega_k dt)
+    Eigen::ArrayXd rotation_im_;  ///< sin(omega_k dt)
+    std::shared_ptr<const HarmonicSynthesis> synthesis_;  ///< for uniformly spaced frequencies, null otherwise
+    Eigen::MatrixXcd coefficients_;                       ///< A_k exp(i phase_k), for synthesis_
+};
+
+/**
+ * @brief Sliding window over the samples of a FreeSurfaceElevationGenerator.
+ *
+ * Keeps the last requested range and one chunk ahead. When the requested range moves forward, as with the excitation
+ * convolution during a simulation, the overlapping samples are reused and only the new ones are generated. The memory
+ * is bounded by the longest requested range plus one chunk.
+ */
+class FreeSurfaceElevationWindow {
+  public:
+    /**
+     * @brief Gets the samples first,...,last of generator, generating the ones not in the window.
+     *
+     * @param generator generator of the samples, always the same one until Clear()
+     * @param first index of the first sample
+     * @param last index of the last sample, last >= first
+     *
+     * @return pointer to sample first, valid until the next call
+     */
+    const double* GetSamples(const FreeSurfaceElevationGenerator& generator, std::int64_t first, std::int64_t last);
+
+    /**
+     * @brief Drops the samples, for use with another generator.
+     */
+    void Clear();
+
+  private:
+    std::vector<double> samples_;
+    std::int64_t first_ = 0;  ///< index of samples_[0]
+};
+
+#endif
@@ -9,7 +9,10 @@
 // TODO: clean up include statements
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <limits>
+#include <memory>
 #include <optional>
 #include <string>
 #include <variant>
@@ -28,12 +31,57 @@ class H5File;
  */
 
 class H5FileInfo;
+class HydroDatabase;
+class MappedFile;
+
+/**
+ * @brief Optional groups of h5 datasets, only read by H5FileInfo and HydroData when a wave model needs them.
+ *
+ * The body properties, hydrostatics, added mass and radiation data are always read. See
+ * WaveBase::GetHydroDataRequirements() for the groups each wave model uses.
+ */
+struct HydroDataRequirements {
+    bool regular_excitation   = false;  ///< wave frequencies, excitation magnitude and phase (RegularWave)
+    bool irregular_excitation = false;  ///< wave frequencies, excitation real and imaginary parts (IrregularWaves)
+    bool excitation_irf       = false;  ///< excitation IRF and its time vector (IrregularWaves in the time domain)
+
+    /**
+     * @brief Requirements with every optional group.
+     */
+    static HydroDataRequirements All() { return {true, true, true}; }
+
+    /**
+     * @brief Union of two requirement sets.
+     */
+    HydroDataRequirements operator|(const HydroDataRequirements& other) const {
+        return {regular_excitation || other.regular_excitation, irregular_excitation || other.irregular_excitation,
+                excitation_irf || other.excitation_irf};
+    }
+};
+
+/**
+ * @brief Time spent on one dataset by an H5FileInfo read, see H5FileInfo::GetDatasetTimings().
+ */
+struct H5DatasetTiming {
+    std::string name;              ///< dataset path in the h5 file
+    std::size_t num_values = 0;    ///< values stored in HydroData
+    double read_ms         = 0.0;  ///< HDF5 calls, under the HDF5 lock
+    double process_ms      = 0.0;  ///< reordering and scaling of the values, outside of the lock
+};
 
 // TODO separate these 2 classes into 2 files? (and corresponding .cpp)
 
 // contains "chunked" data from the h5 file, generated from H5FileInfor class
 class HydroData {
   public:
+    // state space realization of each RIRF kernel, as stored by bemio in radiation_damping/state_space
+    struct RadiationStateSpaceInfo {
+        Eigen::Tensor<double, 4> A;  // [6, 6N, max order, max order]
+        Eigen::Tensor<double, 4> B;  // [6, 6N, max order, 1]
+        Eigen::Tensor<double, 4> C;  // [6, 6N, 1, max order], scaled by rho
+        Eigen::MatrixXd D;           // [6, 6N], scaled by rho
+        Eigen::MatrixXi order;       // [6, 6N] order of each kernel realization, 0 if none
+    };
     struct BodyInfo {
         std::string body_name;
         int body_num;
@@ -44,7 +92,11 @@ class HydroData {
         Eigen::VectorXd cb;
         Eigen::MatrixXd lin_matrix;
         Eigen::MatrixXd inf_added_mass;
-        Eigen::Tensor<double, 3> rirf_matrix;
+        Eigen::Tensor<double, 3> rirf_matrix;  // empty if rirf_mapped is set
+        // RIRF used in place from a memory mapped hydro database (see HydroDatabase), same layout as rirf_matrix
+        const double* rirf_mapped                    = nullptr;
+        std::array<Eigen::Index, 3> rirf_mapped_dims = {0, 0, 0};
+        std::optional<RadiationStateSpaceInfo> rirf_state_space;  // empty if not in the h5 file
         // Eigen::Tensor<double, 3> radiation_damping_matrix;
     };
     struct SimulationParameters {
@@ -59,10 +111,9 @@ class HydroData {
         Eigen::Tensor<double, 3> excitation_phase_matrix;
     };
     struct IrregularWaveInfo {
-        // Eigen::Tensor<double,3> excitation_re_matrix;
-        // Eigen::Vector3i re_dims;
-        // Eigen::Tensor<double, 3> excitation_im_matrix;
-        // Eigen::Vector3i im_dims;
+        Eigen::VectorXd freq_list;             // wave frequencies of the excitation coefficients [rad/s]
+        Eigen::MatrixXd excitation_re_matrix;  // 6 x frequencies, real part of the excitation coefficients
+        Eigen::MatrixXd excitation_im_matrix;  // 6 x frequencies, imaginary part of the excitation coefficients
         Eigen::VectorXd excitation_irf_time;
         Eigen::MatrixXd excitation_irf_matrix;  // TODO needs to be tensor?
 
@@ -82,7 +133,12 @@ class HydroData {
     // a vector of IrregularWaveInfo, one for each hydro body in system
     // is empty if irregular waves are not used
     std::vector<IrregularWaveInfo> irreg_wave_data_;
+    // optional groups read so far, see Require()
+    HydroDataRequirements loaded_;
+    // hydro database the RIRF of the bodies is mapped from, null if read from an h5 file
+    std::shared_ptr<const MappedFile> mapped_file_;
     friend H5FileInfo;
+    friend HydroDatabase;
     void resize(int num_bodies);
     HydroData() = default;
 
@@ -99,7 +155,7 @@ class HydroData {
      *
      * @return added mass matrix for the body from h5file
      */
-    Eigen::MatrixXd GetInfAddedMassMatrix(int b) const;
+    const Eigen::MatrixXd& GetInfAddedMassMatrix(int b) const;
 
     /**
      * @brief Get specific value of the linear restoring stiffness matrix for body b, row i , column j.
@@ -119,7 +175,7 @@ class HydroData {
      *
      * @return the full linear restoring stiffness matrix for body b
      */
-    Eigen::MatrixXd GetLinMatrix(int b) const;
+    const Eigen::MatrixXd& GetLinMatrix(int b) const;
 
     /**
      * @brief Getter function for value in RIRF matrix.
@@ -149,7 +205,7 @@ class HydroData {
      *
      * @return cg vector from h5file
      */
-    Eigen::VectorXd GetCGVector(int b) const { return body_data_[b].cg; }
+    const Eigen::VectorXd& GetCGVector(int b) const { return body_data_[b].cg; }
 
     /**
      * @brief Get cb vector constant for a body.
@@ -158,11 +214,26 @@ class HydroData {
      *
      * @return cb vector from h5file
      */
-    Eigen::VectorXd GetCBVector(int b) const { return body_data_[b].cb; }
+    const Eigen::VectorXd& GetCBVector(int b) const { return body_data_[b].cb; }
 
     double GetExcitationIRFVal(int b, int dof, int s) const;  // TODO if this isn't used get rid of it
     Eigen::MatrixXd GetExcitationIRF(int b) const;            // TODO if this isn't used get rid of it
 
+    /**
+     * @brief Reads the optional groups of h5 datasets that are required and not loaded yet.
+     *
+     * Reopens the h5 file this data was read from if anything is missing, does nothing otherwise. Called by TestHydro
+     * for the waves it is given, so runs without waves never read the excitation data.
+     *
+     * @param requirements optional groups needed by the caller
+     */
+    void Require(const HydroDataRequirements& requirements);
+
+    /**
+     * @brief Gets the optional groups of h5 datasets loaded so far.
+     */
+    const HydroDataRequirements& GetLoadedRequirements() const { return loaded_; }
+
     // things that are the same no matter the body, don't need body argument
     /**
      * @brief returns the i-th component of the dimensions of radiation_damping_matrix
@@ -180,6 +251,24 @@ class HydroData {
      */
     Eigen::VectorXd GetRIRFTimeVector() const;
 
+    /**
+     * @brief Checks if the h5 file has a state space realization of the RIRF for every body.
+     *
+     * @return true if GetRadiationStateSpace() can be called for all bodies
+     */
+    bool HasRadiationStateSpace() const;
+
+    /**
+     * @brief Get the state space realization of the RIRF kernels of a body.
+     *
+     * C and D are scaled by rho when initialized, do not need to be scaled here.
+     *
+     * @param b which body, 0 indexed
+     *
+     * @return state space matrices for the 6 x 6N kernels of body b
+     */
+    const RadiationStateSpaceInfo& GetRadiationStateSpace(int b) const;
+
     /**
      * @brief Get water density rho.
      *
@@ -196,6 +285,7 @@ class HydroData {
      * @return vector containing BodyInfo classes info for each body in system with hydro forces on it
      */
     std::vector<BodyInfo>& GetBodyInfos() { return body_data_; }
+    const std::vector<BodyInfo>& GetBodyInfos() const { return body_data_; }
 
     /**
      * @brief Get chunk of data corresponding to the SimulationParameters struct in this class.
@@ -205,6 +295,7 @@ class HydroData {
      * @return SimulationParameters info for the system
      */
     SimulationParameters& GetSimulationInfo() { return sim_data_; }
+    const SimulationParameters& GetSimulationInfo() const { return sim_data_; }
 
     /**
      * @brief Get chunk of data corresponding to the RegularWaveInfo struct in this class.
@@ -214,6 +305,7 @@ class HydroData {
      * @return vector containing RegularWaveInfo classes info for each body in system with hydro forces on it
      */
     std::vector<RegularWaveInfo>& GetRegularWaveInfos() { return reg_wave_data_; }
+    const std::vector<RegularWaveInfo>& GetRegularWaveInfos() const { return reg_wave_data_; }
 
     /**
      * @brief Get chunk of data corresponding to the IrregularWaveInfo struct in this class.
@@ -223,6 +315,7 @@ class HydroData {
      * @return vector containing IrregularWaveInfo classes info for each body in system with hydro forces on it
      */
     std::vector<IrregularWaveInfo>& GetIrregularWaveInfos() { return irreg_wave_data_; }
+    const std::vector<IrregularWaveInfo>& GetIrregularWaveInfos() const { return irreg_wave_data_; }
 };
 
 // TODO change name to LoadH5File or ReadH5File or H5Init or something similar to give better description of
@@ -235,8 +328,7 @@ class H5FileInfo {
      * @brief prepares for h5 file reading, checks file exists.
      *
      * @param file string containing file name for h5 hydro data file
-     * @param num_bod number of hydro bodies in system = number of bodies in h5 file \
-     * note, hydrobodies should be added to system before any non hydrobodies
+     * @param num_bod number of hydro bodies in system = number of bodies in h5 file
      */
     H5FileInfo(std::string file, int num_bod = 1);
     H5FileInfo() = delete;
@@ -253,15 +345,83 @@ class H5FileInfo {
      * @brief Creates HydroData object and populates it with info from h5 file.
      *
      * h5_file_name needs to be set before readH5Data called (usually set in constructor).
-     * calls Initialize functions to read h5 file information into  member variables.]
+     * calls Initialize functions to read h5 file information into  member variables.] The bodies are read on
+     * SetNumThreads() threads.
+     *
+     * @param requirements optional groups of datasets to read, all by default, see HydroData::Require() to read more
+     * later
      *
      * @return newly initialized HydroData object
      */
-    HydroData ReadH5Data();  // TODO: eventually pass user input struct here? instead of making it in function?
+    HydroData ReadH5Data(const HydroDataRequirements& requirements = HydroDataRequirements::All());
+
+    /**
+     * @brief Reads the optional groups of datasets into data, which must have been read from the same file.
+     *
+     * Groups already loaded in data are read again.
+     *
+     * @param data HydroData to complete
+     * @param requirements optional groups of datasets to read
+     */
+    void ReadOptionalData(HydroData& data, const HydroDataRequirements& requirements);
+
+    /**
+     * @brief Sets the number of threads reading the bodies, 1 by default.
+     *
+     * Each thread reads the datasets of one body at a time. The HDF5 calls of all threads are serialized by one lock,
+     * as the library is not thread safe, and the values read are reordered and scaled outside of it, while the other
+     * threads read.
+     *
+     * @param num_threads number of threads, 0 for the OpenMP default; always 1 without OpenMP
+     */
+    void SetNumThreads(int num_threads);
+
+    /**
+     * @brief Gets the time spent on each dataset by the last ReadH5Data() or ReadOptionalData() call.
+     *
+     * @return one entry per dataset, in the order the reads completed
+     */
+    const std::vector<H5DatasetTiming>& GetDatasetTimings() const { return timings_; }
 
   private:
     std::string h5_file_name_;
     int num_bodies_;
+    int num_threads_ = 1;
+    std::vector<H5DatasetTiming> timings_;
+
+    /**
+     * @brief helper function for readH5Data() to read the datasets of a body, called concurrently for the bodies.
+     *
+     * @param[in] file open h5 file reference to read data from
+     * @param[in,out] data HydroData with the simulation parameters already read
+     * @param[in] b body, 0 indexed
+     */
+    void InitBodyData(H5::H5File& file, HydroData& data, int b);
+
+    /**
+     * @brief helper function for readH5Data() and ReadOptionalData() to read optional groups from an open file.
+     *
+     * @param[in] file open h5 file reference to read data from
+     * @param[in,out] data HydroData with the simulation parameters already read
+     * @param[in] requirements optional groups of datasets to read
+     */
+    void InitOptionalData(H5::H5File& file, HydroData& data, const HydroDataRequirements& requirements);
+
+    /**
+     * @brief helper function for InitOptionalData() to read the optional groups of a body, called concurrently for the
+     * bodies.
+     *
+     * @param[in] file open h5 file reference to read data from
+     * @param[in,out] data HydroData with the simulation parameters already read
+     * @param[in] requirements optional groups of datasets to read
+     * @param[in] freq_list wave frequencies, read once for all bodies
+     * @param[in] b body, 0 indexed
+     */
+    void InitOptionalBodyData(H5::H5File& file,
+                              HydroData& data,
+                              const HydroDataRequirements& requirements,
+                              const Eigen::VectorXd& freq_list,
+                              int b);
 
     /**
      * @brief helper function for readH5Data() to initialize any scalars.
@@ -278,40 +438,72 @@ class H5FileInfo {
      * @param[in] file open h5 file reference to read data from
      * @param[in] data_name data name within file to extract value from
      * @param[out] var variable to be set from h5 info
+     * @param[in] scale factor applied to the values as they are read
      */
-    void Init1D(H5::H5File& file, std::string data_name, Eigen::VectorXd& var);
+    void Init1D(H5::H5File& file, std::string data_name, Eigen::VectorXd& var, double scale = 1.0);
 
     /**
      * @brief helper function for readH5Data() to initialize any 2D data (matrices)
      *
+     * The data is read directly into the storage of var, one hyperslab per row of the file.
+     *
      * @param[in] file open h5 file reference to read data from
      * @param[in] data_name data name within file to extract value from
      * @param[out] var variable to be set from h5 info
+     * @param[in] scale factor applied to the values as they are read
      */
-    void Init2D(H5::H5File& file, std::string data_name, Eigen::MatrixXd& var);
+    void Init2D(H5::H5File& file, std::string data_name, Eigen::MatrixXd& var, double scale = 1.0);
 
     /**
      * @brief helper function for readH5Data() to initialize any 3D data.
      *
-     * lists of matrices, or lists of vectors (yes this looks like 2d but is stored weird in h5 file, see squeeze_mid)
+     * lists of matrices, or lists of vectors (yes this looks like 2d but is stored weird in h5 file, see
+     * InitSqueezeMid). The data is read directly into the storage of var, one hyperslab per line along the last
+     * dimension of the file.
      *
      * @param[in] file open h5 file reference to read data from
      * @param[in] data_name data name within file to extract value from
      * @param[out] var variable to be set from h5 info
+     * @param[in] scale factor applied to the values as they are read
      */
-    void Init3D(H5::H5File& file, std::string data_name, Eigen::Tensor<double, 3>& var /*, std::vector<int>& dims*/);
+    void Init3D(H5::H5File& file, std::string data_name, Eigen::Tensor<double, 3>& var, double scale = 1.0);
 
     /**
-     * @brief helper function for readH5Data() to remove the middle index of 3D data if that index is 1.
+     * @brief helper function for readH5Data() to initialize any 4D data (e.g. state space matrices of each kernel).
      *
-     * Some data in the h5 file is a list of 1D vectors that should be 2D data, but needs to be read in as 3D data \
-     * Should operate similarly to a MatLab squeeze function.
+     * @param[in] file open h5 file reference to read data from
+     * @param[in] data_name data name within file to extract value from
+     * @param[out] var variable to be set from h5 info
+     * @param[in] scale factor applied to the values as they are read
+     */
+    void Init4D(H5::H5File& file, std::string data_name, Eigen::Tensor<double, 4>& var, double scale = 1.0);
+
+    /**
+     * @brief helper function for readH5Data() to read the optional state space realization of the RIRF of a body.
      *
-     * @param to_be_squeezed is the 3D data (Eigen::Tensor) that the middle index needs to be removed from
+     * @param[in] file open h5 file reference to read data from
+     * @param[in] body_name name of the body group in the file
+     * @param[in] rho water density, C and D are scaled by it
      *
-     * @return 2D matrix representing same data as to_be_squeezed, but in Eigen::Matrix, it is much easier to handle
+     * @return state space data, or empty if the file has none for this body
+     */
+    std::optional<HydroData::RadiationStateSpaceInfo> InitRadiationStateSpace(H5::H5File& file,
+                                                                               const std::string& body_name,
+                                                                               double rho);
+
+    /**
+     * @brief helper function for readH5Data() to read 3D data without its middle index, which should be 1.
+     *
+     * Some data in the h5 file is a list of 1D vectors that should be 2D data, but is stored as 3D data. Should
+     * operate similarly to a MatLab squeeze function: only index 0 of the middle dimension is read, directly into the
+     * rows of var.
+     *
+     * @param[in] file open h5 file reference to read data from
+     * @param[in] data_name data name within file to extract value from
+     * @param[out] var 2D matrix representing the same data, much easier to handle than an Eigen::Tensor
+     * @param[in] scale factor applied to the values as they are read
      */
-    Eigen::MatrixXd SqueezeMid(Eigen::Tensor<double, 3>& to_be_squeezed);
+    void InitSqueezeMid(H5::H5File& file, std::string data_name, Eigen::MatrixXd& var, double scale = 1.0);
 };
 
 #endif
\ No newline at end of file
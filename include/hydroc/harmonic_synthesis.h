@@ -0,0 +1,79 @@
+#ifndef HARMONIC_SYNTHESIS_H
+#define HARMONIC_SYNTHESIS_H
+/*********************************************************************
+ * @file  harmonic_synthesis.h
+ *
+ * @brief header file for the FFT based synthesis of time series from \
+ * sums of harmonics with uniformly spaced frequencies.
+ *********************************************************************/
+#pragma once
+
+#include <Eigen/Dense>
+#include <unsupported/Eigen/FFT>
+
+/**
+ * @brief Evaluates sums of harmonics with uniformly spaced frequencies on a uniform time grid.
+ *
+ * For each column c of the coefficients, computes
+ * x_c(t_n) = Re( sum_k coefficients(k, c) exp(i (omega_0 + k d_omega) t_n) ), with t_n = t_0 + n dt.
+ *
+ * The sums are evaluated as a chirp z-transform (Bluestein's algorithm): with W = exp(i d_omega dt) and
+ * k n = (k^2 + n^2 - (n - k)^2) / 2, the sum over k becomes a convolution, which is computed with FFTs. This is exact
+ * (up to round-off) for any frequency spacing and time step, not only when the FFT grid matches the time grid.
+ * Time samples are computed in blocks of about K samples for K frequencies, so the cost is O(N log K) for N samples
+ * instead of O(N K), and the memory does not depend on N.
+ *
+ * Synthesize() only reads the precomputed chirps and can be called concurrently.
+ */
+class HarmonicSynthesis {
+  public:
+    /**
+     * @brief Sets up the frequencies and time step, precomputes the chirp spectrum.
+     *
+     * @param num_frequencies number of harmonics K
+     * @param omega_0 frequency of the first harmonic [rad/s]
+     * @param d_omega frequency spacing [rad/s]
+     * @param dt time step of the synthesized series
+     */
+    HarmonicSynthesis(int num_frequencies, double omega_0, double d_omega, double dt);
+
+    /**
+     * @brief Evaluates the sums of harmonics at num_samples uniform times from t_0.
+     *
+     * @param coefficients K x C complex amplitudes, one column per series
+     * @param t_0 time of the first sample
+     * @param num_samples number of time samples N
+     *
+     * @return N x C real time series
+     */
+    Eigen::MatrixXd Synthesize(const Eigen::Ref<const Eigen::MatrixXcd>& coefficients,
+                               double t_0,
+                               int num_samples) const;
+
+    /**
+     * @brief Number of time samples computed per block (one FFT and inverse FFT per series).
+     */
+    int GetBlockSize() const { return block_size_; }
+
+  private:
+    int num_frequencies_;
+    double omega_0_;
+    double d_omega_;
+    double dt_;
+    int fft_size_;
+    int block_size_;
+    Eigen::VectorXcd chirp_;           ///< W^(k^2 / 2), for k = 0,...,max(K, block size)
+    Eigen::VectorXcd chirp_spectrum_;  ///< FFT of W^(-j^2 / 2), j = -(K - 1),...,block size - 1 (circular)
+};
+
+/**
+ * @brief Checks that values are uniformly spaced, as the frequencies or the times of HarmonicSynthesis.
+ *
+ * @param values at least two values
+ * @param tolerance allowed deviation from the uniform grid, relative to the spacing
+ *
+ * @return true if every value is within tolerance of values[0] + i (values[last] - values[0]) / last
+ */
+bool IsUniformlySpaced(const Eigen::Ref<const Eigen::VectorXd>& values, double tolerance = 1e-6);
+
+#endif
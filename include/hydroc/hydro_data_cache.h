@@ -0,0 +1,69 @@
+#ifndef HYDRO_DATA_CACHE_H
+#define HYDRO_DATA_CACHE_H
+/*********************************************************************
+ * @file  hydro_data_cache.h
+ *
+ * @brief header file for the process wide cache of HydroData shared \
+ * by TestHydro instances.
+ *********************************************************************/
+#pragma once
+
+#include <hydroc/h5fileinfo.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/**
+ * @brief Process wide cache of immutable HydroData, shared by the TestHydro instances built on the same file.
+ *
+ * Entries are keyed by the absolute file path, its modification time and the number of bodies: a file modified since
+ * it was cached is read again. The cache holds a reference to each entry until Clear() is called, and the data stays
+ * alive while a TestHydro uses it. Thread safe, files are loaded one at a time (HDF5 is not reentrant).
+ *
+ * Typical use, for a parameter sweep over many systems in one process:
+ *
+ *     auto hydro_data = HydroDataCache::Get(h5_file_name, 2);
+ *     TestHydro hydro_forces(bodies, hydro_data, waves);
+ */
+class HydroDataCache {
+  public:
+    /**
+     * @brief Gets the shared hydro data of a file, loaded on the first call for the file and number of bodies.
+     *
+     * @param file_name h5 file or hydro database (see HydroDatabase)
+     * @param num_bodies number of hydro bodies in the system
+     * @param requirements optional groups of h5 datasets the data must have, all by default. A cached entry without
+     * some of them is replaced by data with both its groups and the required ones (previous users keep theirs).
+     *
+     * @return the shared data, throws like Load() if the file cannot be read
+     */
+    static std::shared_ptr<const HydroData> Get(
+        const std::string& file_name,
+        int num_bodies,
+        const HydroDataRequirements& requirements = HydroDataRequirements::All());
+
+    /**
+     * @brief Loads the hydro data of a file without caching it.
+     *
+     * @param file_name hydro database if the file starts with its header (see HydroDatabase::IsDatabase()), h5 file
+     * otherwise
+     * @param num_bodies number of hydro bodies in the system
+     * @param requirements optional groups of h5 datasets to read
+     *
+     * @return newly loaded data
+     */
+    static HydroData Load(const std::string& file_name, int num_bodies, const HydroDataRequirements& requirements);
+
+    /**
+     * @brief Releases the references held by the cache, the data in use is freed with its last user.
+     */
+    static void Clear();
+
+    /**
+     * @brief Gets the number of cached entries.
+     */
+    static std::size_t GetSize();
+};
+
+#endif
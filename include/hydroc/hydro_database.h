@@ -0,0 +1,61 @@
+#ifndef HYDRO_DATABASE_H
+#define HYDRO_DATABASE_H
+/*********************************************************************
+ * @file  hydro_database.h
+ *
+ * @brief header file for preprocessed binary hydro databases, \
+ * HydroData written once and memory mapped at startup.
+ *********************************************************************/
+#pragma once
+
+#include <hydroc/h5fileinfo.h>
+
+#include <string>
+
+/**
+ * @brief Binary hydro database: a HydroData read once from an h5 file, stored as prepared for the simulation.
+ *
+ * The values are stored the way HydroData holds them after H5FileInfo::ReadH5Data(): scaled by rho where the h5 reader
+ * scales them, in Eigen column-major order, with the derived values (RIRF time step) computed. Loading only checks the
+ * header and copies the small arrays: the file is memory mapped and the RIRF, by far the largest dataset, is used in
+ * place, so its pages are read on demand and shared by all the processes loading the same database.
+ *
+ * The format is versioned and in native byte order, databases are not portable between machines of different
+ * endianness. TestHydro accepts a database wherever it accepts an h5 file (see IsDatabase()), and the h5_to_hydrodb
+ * tool converts h5 files.
+ */
+class HydroDatabase {
+  public:
+    /**
+     * @brief Writes hydro data to a database.
+     *
+     * Only the optional groups loaded in data are written (see HydroData::GetLoadedRequirements()), a database loaded
+     * later reads the missing ones from the h5 file data was read from.
+     *
+     * @param file_name database file to write, throws std::runtime_error on failure
+     * @param data hydro data, usually from H5FileInfo::ReadH5Data() with every optional group
+     */
+    static void Write(const std::string& file_name, const HydroData& data);
+
+    /**
+     * @brief Loads a database written by Write().
+     *
+     * @param file_name database file, memory mapped for the lifetime of the returned data and its copies
+     * @param num_bodies number of hydro bodies in the system, must be the number of bodies in the database
+     *
+     * @return the hydro data, throws std::runtime_error if the file cannot be read, is not a database of this version
+     * or is truncated, std::invalid_argument if the number of bodies differs
+     */
+    static HydroData Read(const std::string& file_name, int num_bodies);
+
+    /**
+     * @brief Checks if a file starts with the database header (h5 files do not).
+     *
+     * @param file_name file to check
+     *
+     * @return false if the file cannot be read or is not a database
+     */
+    static bool IsDatabase(const std::string& file_name);
+};
+
+#endif
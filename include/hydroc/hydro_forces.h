@@ -34,6 +34,12 @@
 
 // Hydroc library includes
 #include <hydroc/h5fileinfo.h>
+#include <hydroc/radiation_convolution.h>
+#include <hydroc/radiation_coupling.h>
+#include <hydroc/radiation_fft_convolution.h>
+#include <hydroc/radiation_state_space.h>
+#include <hydroc/rirf_fit.h>
+#include <hydroc/time_history_buffer.h>
 #include <hydroc/wave_types.h>
 
 using namespace chrono;
@@ -87,6 +93,8 @@ class ComponentFunc : public ChFunction {
 
 /**
  * @brief Organizes the functional (time-dependent) forces in each degree of freedom (6 total) for a body.
+ *
+ * @note TestHydro applies its forces with ChLoadHydroForces instead, ForceFunc6d is kept for custom setups.
  */
 class ForceFunc6d {
   public:
@@ -148,6 +156,35 @@ class ForceFunc6d {
 };
 
 class ChLoadAddedMass;
+class ChLoadHydroForces;
+
+enum class RadiationMode {
+    /// @brief Direct convolution of the h5 RIRF with the velocity history, interpolated at the RIRF time steps
+    convolution = 0,
+    /// @brief Direct convolution with the RIRF resampled once to a fixed simulation time step
+    convolutionFixedStep = 1,
+    /// @brief State space realization of the RIRF stored in the h5 file (bemio radiation_damping/state_space)
+    stateSpace = 2,
+    /// @brief State space models identified from the h5 RIRF when the radiation options are set
+    stateSpaceFit = 3,
+    /// @brief Convolution with the RIRF resampled to a fixed time step, evaluated with partitioned FFTs
+    convolutionFFT = 4
+};
+
+/**
+ * @brief User options for the radiation damping force computed in TestHydro.
+ */
+struct RadiationParams {
+    RadiationMode mode_ = RadiationMode::convolution;
+    double timestep_        = 0.0;   // fixed time step for convolutionFixedStep/FFT, 0 uses the ChSystem step
+    double fit_tolerance_   = 1e-2;  // stateSpaceFit: target relative error of each fitted kernel
+    int fit_max_order_      = 10;    // stateSpaceFit: maximum number of states of each fitted kernel
+    int fft_block_size_     = 0;     // convolutionFFT: RIRF partition size (power of 2), 0 for about sqrt(RIRF size)
+    int num_threads_        = 1;     // convolution/convolutionFixedStep: threads over force DoFs, 0 for OpenMP default
+    double prune_tolerance_ = 0.0;   // skip kernels with norm <= tolerance * largest kernel norm, 0 skips zero kernels
+    // body pairs (0-based, unordered) that radiate onto each other, empty for all pairs
+    std::vector<std::pair<int, int>> body_interactions_;
+};
 
 // TODO: Rename TestHydro for clarity, perhaps to HydroForces?
 // TODO: Split TestHydro class from its helper classes for clearer code structure.
@@ -159,16 +196,32 @@ class TestHydro {
      * @brief Main constructor for initializing the TestHydro class.
      *
      * Sets up vector of bodies, h5 file info, and hydro inputs. If no waves are given,
-     * this constructor defaults to using NoWave.
+     * this constructor defaults to using NoWave. Only the excitation datasets needed by the waves are read from the h5
+     * file, so decay tests never read excitation data. A preprocessed hydro database (see HydroDatabase) can be given
+     * instead of the h5 file, it is memory mapped instead of read.
      *
      * @param user_bodies List of pointers to bodies for the hydro forces.
-     * @param h5_file_name Name of the h5 file where hydro data is stored.
+     * @param h5_file_name Name of the h5 file or hydro database where hydro data is stored.
      * @param waves WaveBase object. Defaults to NoWave if not provided.
      */
     TestHydro(std::vector<std::shared_ptr<ChBody>> user_bodies,
               std::string h5_file_name,
               std::shared_ptr<WaveBase> waves = std::make_shared<NoWave>());
 
+    /**
+     * @brief Constructor sharing hydro data already loaded, e.g. by other instances (see HydroDataCache).
+     *
+     * The data is never modified: excitation datasets the waves need and the data lacks are read into a copy owned by
+     * this instance (once, later waves complete that copy in place).
+     *
+     * @param user_bodies List of pointers to bodies for the hydro forces.
+     * @param hydro_data Hydro data of the bodies, throws std::invalid_argument if null or for another number of bodies.
+     * @param waves WaveBase object. Defaults to NoWave if not provided.
+     */
+    TestHydro(std::vector<std::shared_ptr<ChBody>> user_bodies,
+              std::shared_ptr<const HydroData> hydro_data,
+              std::shared_ptr<WaveBase> waves = std::make_shared<NoWave>());
+
     // Deleted copy constructor and assignment operator for safety.
     TestHydro(const TestHydro& old) = delete;
     TestHydro& operator=(const TestHydro& rhs) = delete;
@@ -176,38 +229,187 @@ class TestHydro {
     /**
      * @brief Adds waves class to force calculations depending on if regular or irregular waves.
      *
-     * Also initializes h5 data for wave force class.
+     * Also initializes h5 data for wave force class, reading the excitation datasets the waves need from the h5 file
+     * if they were not loaded yet (see WaveBase::GetHydroDataRequirements()).
      *
      * @param waves the specific WaveBase class to add to the system
      */
     void AddWaves(std::shared_ptr<WaveBase> waves);
 
+    /**
+     * @brief Selects how the radiation damping force is computed.
+     *
+     * Rebuilds the radiation kernel and clears the velocity history, so it should be called before the first time
+     * step. With RadiationMode::convolutionFixedStep the RIRF is resampled once to the fixed time step, and as long as
+     * the simulation advances by exactly that step each lag of the RIRF maps directly to a stored velocity sample
+     * (no search or interpolation). Steps of a different size fall back to interpolating the velocity history.
+     * With RadiationMode::stateSpace the radiation states are set up from the h5 file, which must contain them. With
+     * RadiationMode::stateSpaceFit a state space model is fitted to each RIRF kernel here, see GetRadiationFitReport().
+     * RadiationMode::convolutionFFT uses the same resampled RIRF as convolutionFixedStep, split in partitions for
+     * RadiationFFTConvolution, and requires every step to be the fixed time step.
+     *
+     * @param params radiation options, see RadiationParams
+     */
+    void SetRadiationParams(const RadiationParams& params);
+
+    /**
+     * @brief Gets the current radiation options.
+     *
+     * @return the RadiationParams in use
+     */
+    const RadiationParams& GetRadiationParams() const { return radiation_params_; }
+
+    /**
+     * @brief Gets the load applying the added mass, and holding the Jacobians of the implicit options, to the bodies.
+     *
+     * @return the added mass load, owned by the load container of the system
+     */
+    std::shared_ptr<ChLoadAddedMass> GetAddedMassLoad() const { return my_loadbodyinertia; }
+
+    /**
+     * @brief Checks if the whole velocity history is evenly spaced by the fixed radiation time step.
+     *
+     * In RadiationMode::convolutionFixedStep the convolution then reads the stored samples directly instead of
+     * interpolating them, from the second time step on as long as the simulation advances by the fixed step.
+     *
+     * @return true if the last convolution used the stored samples directly
+     */
+    bool IsRadiationHistoryUniform() const;
+
+    /**
+     * @brief Selects if the hydrostatic restoring force is treated implicitly or explicitly (default).
+     *
+     * Implicitly, the stiffness rho g lin_matrix is added to the K Jacobian of the hydro load (see
+     * ChLoadAddedMass::SetHydrostaticStiffness()), and the hydrostatic force follows the body positions of every
+     * iteration of the integrator within a time step. This allows larger stable time steps for stiff heave and pitch
+     * modes, but changes the trajectories of the reference results. Explicitly, like the radiation and wave forces,
+     * the force of the first evaluation of each time step is used for the whole step.
+     *
+     * @param implicit true for the implicit treatment
+     */
+    void SetImplicitHydrostatics(bool implicit);
+
+    /**
+     * @brief Checks if the hydrostatic restoring force is treated implicitly, see SetImplicitHydrostatics().
+     */
+    bool GetImplicitHydrostatics() const { return implicit_hydrostatics_; }
+
+    /**
+     * @brief Selects if the instantaneous radiation damping is treated implicitly or explicitly (default).
+     *
+     * The most recent lag of the convolution, rho K(0) times its integration width, is a damping proportional to the
+     * current velocity. Implicitly, it is added to the R Jacobian of the hydro load (see
+     * ChLoadAddedMass::SetRadiationDamping()) and follows the body velocities of every iteration of the integrator
+     * within a time step, while the older lags stay explicit; it also applies from the first time step, when the
+     * explicit convolution has no history yet. This changes the trajectories of the reference results. Only used by
+     * the convolution radiation modes.
+     *
+     * @param implicit true for the implicit treatment
+     */
+    void SetImplicitRadiation(bool implicit);
+
+    /**
+     * @brief Checks if the instantaneous radiation damping is treated implicitly, see SetImplicitRadiation().
+     */
+    bool GetImplicitRadiation() const { return implicit_radiation_; }
+
+    /**
+     * @brief Gets the order and error of the model fitted to each RIRF kernel in RadiationMode::stateSpaceFit.
+     *
+     * Errors are relative to the largest kernel of the system. Kernels below the fit tolerance at that scale are
+     * dropped and not listed.
+     *
+     * @return one entry per fitted kernel, empty in the other radiation modes
+     */
+    const std::vector<RIRFFitSummary>& GetRadiationFitReport() const { return radiation_fit_report_; }
+
+    /**
+     * @brief Gets the RIRF kernels used by the radiation force, and how many were pruned.
+     *
+     * Built from the h5 RIRF with RadiationParams::prune_tolerance_ and RadiationParams::body_interactions_. Pruned
+     * kernels are skipped by the convolution, not set up in the state space modes, and zero in the FFT partitions.
+     *
+     * @return the sparsity map of the RIRF kernels
+     */
+    const RadiationCouplingMap& GetRadiationCoupling() const { return radiation_coupling_; }
+
+    /**
+     * @brief Computes the total 6N hydro force for the given body states, once per time step.
+     *
+     * Called by ChLoadHydroForces at each update of the system. The force is hydrostatics minus radiation damping
+     * plus waves, computed at the system time; later calls at the same time return the force of the first call, as
+     * the radiation history must only advance once per time step. With implicit hydrostatics (see
+     * SetImplicitHydrostatics()) the hydrostatic part is updated for the positions of each call, and with implicit
+     * radiation (see SetImplicitRadiation()) the instantaneous radiation damping for the velocities of each call.
+     *
+     * @param positions 6N body positions and Euler123 rotations
+     * @param velocities 6N body linear and angular velocities, in the absolute frame
+     *
+     * @return 6N dimensional total force (forces and torques in the absolute frame)
+     */
+    const std::vector<double>& ComputeTotalForce(const Eigen::Ref<const Eigen::VectorXd>& positions,
+                                                 const Eigen::Ref<const Eigen::VectorXd>& velocities);
+
     /**
      * @brief Computes the Hydrostatic stiffness force plus buoyancy force for a 6N dimensional system.
      *
+     * Uses the body positions of the current state sample (see ComputeTotalForce()).
+     *
      * @return 6N dimensional force for 6 DOF and N bodies in system.
      */
-    std::vector<double> ComputeForceHydrostatics();
+    const std::vector<double>& ComputeForceHydrostatics();
 
     /**
      * @brief Computes the Radiation Damping force with convolution history for a 6N dimensional system.
      *
      * The discretization uses the time series of the the RIRF relative to the current step.
      * Linear interpolation is done on the velocity history if time_sim-time_rirf is between two values of the time
-     * history. Trapezoidal integration is used to compute the force.
+     * history. Trapezoidal integration is used to compute the force, using the kernel precomputed in
+     * InitializeRadiationKernel(), so the convolution itself is a matrix-vector product.
+     *
+     * The velocities of the current state sample are automatically added to the time history in this function (so it
+     * should only be called once per time step), and history that is older than the maximum RIRF time value is
+     * automatically removed.
+     *
+     * In RadiationMode::convolutionFixedStep the RIRF time steps match the history samples, and the velocities are
+     * read directly from the history without interpolation.
+     *
+     * The matrix-vector product is split over blocks of force DoFs on RadiationParams::num_threads_ threads, see
+     * AddRadiationConvolution(). The most recent lag is applied to the current velocities as the instantaneous
+     * damping matrix (see SetImplicitRadiation()).
+     *
+     * @return 6N dimensional force for 6 DOF and N bodies in system.
+     */
+    const std::vector<double>& ComputeForceRadiationDampingConv();
+
+    /**
+     * @brief Computes the Radiation Damping force from the state space realization of the RIRF.
+     *
+     * Used in RadiationMode::stateSpace instead of ComputeForceRadiationDampingConv(). The radiation states are
+     * advanced from the previous call to the current time with the sampled body velocities, so the cost per step
+     * only depends on the number of states, not on the length of the RIRF. Like the convolution, it should only be
+     * called once per time step.
+     *
+     * @return 6N dimensional force for 6 DOF and N bodies in system.
+     */
+    const std::vector<double>& ComputeForceRadiationDampingStateSpace();
+
+    /**
+     * @brief Computes the Radiation Damping force with the partitioned FFT convolution.
      *
-     * Time history is automatically added in this function (so it should only be called once per time step), and
-     * history that is older than the maximum RIRF time value is automatically removed.
+     * Used in RadiationMode::convolutionFFT instead of ComputeForceRadiationDampingConv(). Gives the same result as
+     * RadiationMode::convolutionFixedStep (up to round-off), but the cost per step grows with the square root of the
+     * RIRF length instead of linearly. Should only be called once per time step, with the fixed time step.
      *
      * @return 6N dimensional force for 6 DOF and N bodies in system.
      */
-    std::vector<double> ComputeForceRadiationDampingConv();
+    const std::vector<double>& ComputeForceRadiationDampingFFT();
 
     /**
      * @brief Computes the 6N dimensional force from any waves applied to the system.
      * @return 6N dimensional force for 6 DOF and N bodies in system (already Eigen type).
      */
-    Eigen::VectorXd ComputeForceWaves();
+    const Eigen::VectorXd& ComputeForceWaves();
 
     /**
      * @brief Fetches the RIRF value from the h5 file based on the provided indices.
@@ -224,7 +426,10 @@ class TestHydro {
      * @brief Calculates or retrieves the total force on a specific body in a particular degree of freedom.
      *
      * If the total force for the body and DOF was computed for the current timestep, it's retrieved.
-     * Otherwise, the function calculates it. Note: Body index is 1-based here due to its origin from ForceFunc6d.
+     * Otherwise, the function calculates it from the current body states. Note: Body index is 1-based here due to its
+     * origin from ForceFunc6d.
+     * The force components are computed into preallocated members, so that after the first time steps no heap
+     * allocation is made (see hydro_step_allocations_t01).
      *
      * @param b Body index (1-based due to source from ForceFunc6d).
      * @param i Degree of Freedom (DOF) index, ranging from [0,...5].
@@ -237,8 +442,8 @@ class TestHydro {
     // Class properties related to the body and hydrodynamics
     std::vector<std::shared_ptr<ChBody>> bodies_;
     int num_bodies_;
-    HydroData file_info_;
-    std::vector<ForceFunc6d> force_per_body_;
+    std::shared_ptr<const HydroData> file_info_;  // possibly shared with other instances, see HydroDataCache
+    std::shared_ptr<HydroData> owned_file_info_;  // same data if private to this instance, null while shared
     std::shared_ptr<WaveBase> user_waves_;
 
     // Force components vectors
@@ -250,22 +455,97 @@ class TestHydro {
     // Additional properties related to equilibrium and hydrodynamics
     std::vector<double> equilibrium_;
     std::vector<double> cb_minus_cg_;
-    Eigen::VectorXd rirf_time_vector;  // Assumed consistent for each body
+    RadiationParams radiation_params_;
+    bool implicit_hydrostatics_ = false;  // hydrostatic stiffness in the load Jacobian, force updated within steps
+    bool implicit_radiation_    = false;  // instantaneous radiation damping in the load Jacobian, updated within steps
+    Eigen::VectorXd rirf_time_vector;  // Assumed consistent for each body, resampled in fixed time step modes
     Eigen::VectorXd rirf_width_vector;
 
+    // Radiation convolution kernel, 6N x (6N * T) for T RIRF steps: element (row, col * T + step) holds
+    // rho * K(row, col, step) * rirf_width_vector[step], so each (row, col) kernel is contiguous. Step 0 is zero, it
+    // is held in radiation_instantaneous_ instead
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> radiation_kernel_;
+    // Instantaneous radiation damping rho * K(:, :, 0) * rirf_width_vector[0], 6N x 6N, zero in the state space modes
+    Eigen::MatrixXd radiation_instantaneous_;
+    // Velocities interpolated at t - rirf_time_vector, T x 6N (column-major, matches radiation_kernel_ columns)
+    Eigen::MatrixXd lagged_velocity_;
+
     // Properties for velocity history management and time tracking
-    std::vector<std::vector<std::vector<double>>> velocity_history_;
-    std::vector<double> time_history_;
+    TimeHistoryBuffer velocity_history_;  // 6N velocities per sample, newest first
+    Eigen::VectorXd position_sample_;     // preallocated 6N positions and Euler123 rotations of the current step
+    Eigen::VectorXd velocity_sample_;     // preallocated 6N velocity sample pushed to velocity_history_
+    int uniform_history_size_;            // number of newest history samples spaced by the fixed time step
+    RadiationStateSpace radiation_state_space_;          // radiation states for the state space modes
+    std::vector<RIRFFitSummary> radiation_fit_report_;  // fitted kernels for RadiationMode::stateSpaceFit
+    RadiationFFTConvolution radiation_fft_;              // partitioned convolution for RadiationMode::convolutionFFT
+    RadiationCouplingMap radiation_coupling_;            // RIRF kernels that are not pruned
     double prev_time;
 
-    // Added mass related properties
+    // Added mass and hydro force loads
     std::shared_ptr<ChLoadContainer> my_loadcontainer;
     std::shared_ptr<ChLoadAddedMass> my_loadbodyinertia;
+    std::shared_ptr<ChLoadHydroForces> my_loadhydroforces;
+
+    /**
+     * @brief Builds radiation_coupling_ from the norms of the h5 RIRF kernels, and prints a summary if any is pruned.
+     */
+    void InitializeRadiationCoupling();
+
+    /**
+     * @brief Sets rirf_time_vector and rirf_width_vector, then builds radiation_kernel_ from the h5 RIRF data, scaled
+     * by rho and the trapezoidal integration widths.
+     *
+     * Uses the h5 RIRF time steps, or in RadiationMode::convolutionFixedStep/FFT the multiples of the fixed time step
+     * (RIRF values linearly interpolated). Kernels pruned in radiation_coupling_ are left zero. The first RIRF step is
+     * moved to radiation_instantaneous_.
+     */
+    void InitializeRadiationKernel();
+
+    /**
+     * @brief Clears the velocity history and sizes it to hold a full RIRF window at the given time step.
+     *
+     * @param step expected simulation time step, ignored if not positive
+     */
+    void ResetVelocityHistory(double step);
+
+    /**
+     * @brief Sets up radiation_state_space_ from the state space realization of each RIRF kernel in the h5 file.
+     */
+    void InitializeRadiationStateSpace();
+
+    /**
+     * @brief Sets up radiation_state_space_ by fitting a state space model to each RIRF kernel in the h5 file.
+     *
+     * Fills radiation_fit_report_ and prints a summary.
+     */
+    void InitializeRadiationStateSpaceFit();
+
+    /**
+     * @brief Copies the current 6N body positions (position, then Euler123 rotation for each body) into
+     * position_sample_, and velocities (linear, then angular for each body) into velocity_sample_.
+     */
+    void UpdateBodyStateSample();
+
+    /**
+     * @brief Computes total_force_ from the state sample at the current system time.
+     */
+    void UpdateTotalForce();
+
+    /**
+     * @brief Sums the force components into total_force_.
+     */
+    void AccumulateTotalForce();
+
+    /**
+     * @brief Passes the hydrostatic stiffness and instantaneous radiation damping of the implicit options to the
+     * Jacobian of the added mass load.
+     */
+    void UpdateHydroLoadJacobian();
 
     /**
      * @brief Fetches the velocity history for a specific DOF, body, and timestep.
      *
-     * @param step The timestep index, ranging from [0,1,...,1000].
+     * @param step The history sample index, 0 being the most recent sample.
      * @param c The combined index for the body and DOF, where the order is first by body then by DOF.
      *
      * @return Velocity history for the specified DOF and body at the given timestep.
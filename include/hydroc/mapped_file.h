@@ -0,0 +1,52 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+/*********************************************************************
+ * @file  mapped_file.h
+ *
+ * @brief header file for read-only memory mapped files.
+ *********************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * The contents are paged in by the operating system on access, and processes mapping the same file share the physical
+ * pages. The mapping lives as long as the object, shared with std::shared_ptr by the data pointing into it.
+ */
+class MappedFile {
+  public:
+    /**
+     * @brief Maps a file.
+     *
+     * @param file_name file to map, throws std::runtime_error if it cannot be opened or mapped
+     *
+     * @return the mapping
+     */
+    static std::shared_ptr<const MappedFile> Open(const std::string& file_name);
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    /**
+     * @brief Gets the contents, nullptr for an empty file.
+     */
+    const char* GetData() const { return data_; }
+
+    /**
+     * @brief Gets the size of the file in bytes.
+     */
+    std::size_t GetSize() const { return size_; }
+
+  private:
+    MappedFile() = default;
+
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+#endif
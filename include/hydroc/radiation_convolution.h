@@ -0,0 +1,57 @@
+#ifndef RADIATION_CONVOLUTION_H
+#define RADIATION_CONVOLUTION_H
+/*********************************************************************
+ * @file  radiation_convolution.h
+ *
+ * @brief header file for the direct evaluation of the radiation \
+ * convolution, multithreaded over blocks of force DoFs.
+ *********************************************************************/
+#pragma once
+
+#include <vector>
+
+#include <Eigen/Dense>
+
+/**
+ * @brief Number of force DoFs computed together by one thread, 8 doubles fill one 64 byte cache line.
+ */
+constexpr int kRadiationRowBlock = 8;
+
+/**
+ * @brief Adds the radiation convolution of a lagged velocity window to a force vector.
+ *
+ * The force DoFs are split in blocks of kRadiationRowBlock rows, and each thread evaluates a contiguous range of
+ * blocks. A block is accumulated locally and written once to force, so threads never write to the same cache line
+ * while they compute (no false sharing on the force vector).
+ *
+ * Only the (row, col) kernels listed in coupling are evaluated, see RadiationCouplingMap. Blocks where every kernel
+ * is listed are evaluated as one matrix-vector product per velocity DoF, the others kernel by kernel.
+ *
+ * Without OpenMP, or with a single thread, the blocks are evaluated serially in the same order, with the same result.
+ *
+ * @param kernel rows x (cols * size) row-major kernel, element (row, col * size + lag) is the weight of the velocity
+ * of DoF col lag time steps ago in the force of DoF row (integration weights included)
+ * @param size number of lags of each kernel in kernel
+ * @param velocities num_lags x cols lagged velocities, row lag is the velocity lag steps ago, num_lags <= size
+ * @param coupling for each force DoF, the velocity DoFs of the kernels to evaluate (ascending), empty for all kernels
+ * @param force rows force, the convolution is added to it
+ * @param num_threads number of threads, 0 for the OpenMP default
+ */
+void AddRadiationConvolution(
+    const Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>& kernel,
+    int size,
+    const Eigen::Ref<const Eigen::MatrixXd>& velocities,
+    const std::vector<std::vector<int>>& coupling,
+    Eigen::Ref<Eigen::VectorXd> force,
+    int num_threads);
+
+/**
+ * @brief Number of threads used by AddRadiationConvolution() for a given setting.
+ *
+ * @param num_threads requested number of threads, 0 for the OpenMP default
+ *
+ * @return num_threads, or the OpenMP default for 0; always 1 without OpenMP
+ */
+int GetRadiationNumThreads(int num_threads);
+
+#endif
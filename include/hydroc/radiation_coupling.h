@@ -0,0 +1,58 @@
+#ifndef RADIATION_COUPLING_H
+#define RADIATION_COUPLING_H
+/*********************************************************************
+ * @file  radiation_coupling.h
+ *
+ * @brief header file for the sparsity map of the RIRF kernels, used \
+ * to skip negligible DoF and body couplings in the radiation force.
+ *********************************************************************/
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <Eigen/Dense>
+
+/**
+ * @brief RIRF kernels (force DoF, velocity DoF) that take part in the radiation force, and what was pruned.
+ */
+struct RadiationCouplingMap {
+    std::vector<std::vector<int>> cols;  // for each force DoF, the velocity DoFs of the kept kernels, ascending
+    int num_kernels          = 0;        // kernels of the system, (6N)^2
+    int num_kept             = 0;        // kernels in cols
+    int num_uncoupled        = 0;        // pruned, the bodies do not interact in the interaction graph
+    int num_zero             = 0;        // pruned, identically zero (e.g. symmetries of the body)
+    int num_negligible       = 0;        // pruned, L2 norm below the tolerance
+    int num_body_blocks      = 0;        // body pairs of the system, N^2
+    int num_body_blocks_kept = 0;        // body pairs with at least one kept kernel
+    double max_pruned_norm   = 0.0;      // largest L2 norm of a pruned kernel, relative to the largest kernel
+
+    /**
+     * @brief Checks if a kernel is kept.
+     *
+     * @param row force DoF, 0,...,6N-1
+     * @param col velocity DoF, 0,...,6N-1
+     */
+    bool IsKept(int row, int col) const;
+};
+
+/**
+ * @brief Builds the sparsity map of the RIRF kernels from their L2 norms.
+ *
+ * A kernel is pruned if its bodies do not interact, if it is identically zero, or if its norm is at most tolerance
+ * times the norm of the largest kernel of the system. Each body always interacts with itself.
+ *
+ * @param norms 6N x 6N L2 norms of the RIRF kernels, element (row, col) for the force of DoF row due to the velocity
+ * of DoF col
+ * @param dofs_per_body number of DoFs of each body
+ * @param tolerance relative norm below which kernels are pruned, 0 to prune only zero kernels
+ * @param interactions pairs of body indices (0-based, unordered) that radiate onto each other, empty for all pairs
+ *
+ * @return the sparsity map
+ */
+RadiationCouplingMap BuildRadiationCouplingMap(const Eigen::Ref<const Eigen::MatrixXd>& norms,
+                                               int dofs_per_body,
+                                               double tolerance,
+                                               const std::vector<std::pair<int, int>>& interactions);
+
+#endif
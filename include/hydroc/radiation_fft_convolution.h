@@ -0,0 +1,116 @@
+#ifndef RADIATION_FFT_CONVOLUTION_H
+#define RADIATION_FFT_CONVOLUTION_H
+/*********************************************************************
+ * @file  radiation_fft_convolution.h
+ *
+ * @brief header file for RadiationFFTConvolution, a uniformly \
+ * partitioned overlap-save evaluation of the radiation convolution.
+ *********************************************************************/
+#pragma once
+
+#include <vector>
+
+#include <Eigen/Dense>
+#include <unsupported/Eigen/FFT>
+
+/**
+ * @brief Radiation damping convolution on a fixed time step grid, with the RIRF split in uniform partitions.
+ *
+ * The first partition of B lags (the head) is evaluated directly at every step. The remaining partitions (the tail)
+ * are evaluated with overlap-save FFTs of size 2B once every B steps: the spectra of past velocity blocks are kept in
+ * a frequency domain delay line and multiplied by the spectra of the RIRF partitions, which gives the tail
+ * contribution to the next B steps in one inverse FFT per force DoF.
+ *
+ * For T RIRF steps the cost per step and kernel is O(B + T / B) instead of O(T), with B = sqrt(T) by default. The
+ * result is the same as the direct fixed step convolution up to FFT round-off.
+ */
+class RadiationFFTConvolution {
+  public:
+    using RowMajorMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+    RadiationFFTConvolution() = default;
+
+    /**
+     * @brief Sets up the RIRF partitions and clears the velocity history.
+     *
+     * @param kernel num_dofs x (num_dofs * size) kernel, element (row, col * size + step) is the weight of the velocity
+     * of DoF col step time steps ago in the force of DoF row (integration weights included)
+     * @param num_dofs size of the velocity and force vectors (6N for N bodies)
+     * @param dt fixed time step of the kernel
+     * @param block_size partition size B, rounded up to a power of 2, 0 for about sqrt(size)
+     */
+    void Initialize(const Eigen::Ref<const RowMajorMatrix>& kernel, int num_dofs, double dt, int block_size = 0);
+
+    /**
+     * @brief Clears the velocity history (body at rest before the first step).
+     */
+    void Reset();
+
+    /**
+     * @brief Adds the velocity at time t and computes the radiation force.
+     *
+     * @param t current time, must be one time step after the time of the previous call
+     * @param velocity num_dofs velocities at time t
+     *
+     * @return num_dofs radiation damping force at time t, valid until the next call
+     */
+    const Eigen::VectorXd& Advance(double t, const Eigen::Ref<const Eigen::VectorXd>& velocity);
+
+    /**
+     * @brief Partition size B.
+     */
+    int GetBlockSize() const { return block_size_; }
+
+    /**
+     * @brief Number of partitions of the RIRF, including the directly evaluated head.
+     */
+    int GetNumPartitions() const { return num_partitions_; }
+
+    /**
+     * @brief Number of velocities added by Advance() since the last Reset().
+     */
+    int GetNumSamples() const { return num_samples_; }
+
+  private:
+    int num_dofs_       = 0;
+    int block_size_     = 0;
+    int num_partitions_ = 0;
+    int num_bins_       = 0;  ///< B + 1 bins of the real FFT of size 2B
+    double dt_          = 0.0;
+
+    Eigen::MatrixXd head_kernel_;              ///< num_dofs x (num_dofs * B), lags of each kernel in reverse order
+    Eigen::MatrixXcd tail_spectra_;            ///< bins x (num_dofs^2 * (partitions - 1)) tail partition spectra
+    std::vector<std::vector<int>> tail_cols_;  ///< for each force DoF, the velocity DoFs with a nonzero kernel tail
+    Eigen::MatrixXd input_;                    ///< 2B x num_dofs velocities of the previous and current block
+    Eigen::MatrixXcd input_spectra_;           ///< bins x (num_dofs * (partitions - 1)) delay line of input spectra
+    Eigen::MatrixXd tail_output_;              ///< B x num_dofs tail contribution to the current block
+    Eigen::VectorXcd accumulated_;             ///< bins, work vector for the tail spectrum of one force DoF
+    Eigen::VectorXd block_output_;             ///< 2B, work vector for the inverse FFT
+    Eigen::VectorXd force_;
+    Eigen::FFT<double> fft_;
+    int delay_head_  = 0;  ///< delay line slot of the newest input spectrum
+    int position_    = 0;  ///< step within the current block
+    int num_samples_ = 0;  ///< velocities added since the last Reset()
+    double time_     = 0.0;
+
+    /**
+     * @brief Adds the spectrum of the completed velocity block and computes the tail output of the next block.
+     */
+    void ProcessBlock();
+
+    /**
+     * @brief Column of a tail partition spectrum in tail_spectra_.
+     */
+    int TailColumn(int row, int col, int partition) const {
+        return (row * num_dofs_ + col) * (num_partitions_ - 1) + partition - 1;
+    }
+
+    /**
+     * @brief Column of a delayed input spectrum in input_spectra_, delay 0 being the newest block.
+     */
+    int DelayColumn(int col, int delay) const {
+        return col * (num_partitions_ - 1) + (delay_head_ + delay) % (num_partitions_ - 1);
+    }
+};
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef RADIATION_STATE_SPACE_H
+#define RADIATION_STATE_SPACE_H
+/*********************************************************************
+ * @file  radiation_state_space.h
+ *
+ * @brief header file for RadiationStateSpace, a recursive (state space) \
+ * evaluation of the radiation damping convolution.
+ *********************************************************************/
+#pragma once
+
+#include <vector>
+
+#include <Eigen/Dense>
+
+/**
+ * @brief Radiation damping force from state space realizations of the RIRF kernels.
+ *
+ * Each kernel K(row, col, t) of the RIRF is approximated by a SISO realization (A, B, C, D), so that the convolution
+ * of K with the velocity of DoF col is the output y = C x + D u of x' = A x + B u, with u the velocity. The radiation
+ * force of DoF row is the sum of the outputs of all kernels in that row.
+ *
+ * States are advanced between time steps with the exact discretization of each realization for a velocity that is
+ * linear over the step (first order hold), computed with matrix exponentials. The discretization is cached and only
+ * recomputed if the time step changes, so with a fixed time step the cost per step is O(number of states).
+ */
+class RadiationStateSpace {
+  public:
+    RadiationStateSpace() = default;
+
+    /**
+     * @brief Removes all kernels and sets the number of DoFs of the system.
+     *
+     * @param num_dofs size of the velocity and force vectors (6N for N bodies)
+     */
+    void Clear(int num_dofs);
+
+    /**
+     * @brief Adds the realization of one RIRF kernel.
+     *
+     * @param row DoF of the force the kernel contributes to, in [0, num_dofs)
+     * @param col DoF of the velocity the kernel is applied to, in [0, num_dofs)
+     * @param A n x n state matrix
+     * @param B n x 1 input matrix
+     * @param C 1 x n output matrix
+     * @param D direct feedthrough
+     */
+    void AddKernel(int row,
+                   int col,
+                   const Eigen::Ref<const Eigen::MatrixXd>& A,
+                   const Eigen::Ref<const Eigen::VectorXd>& B,
+                   const Eigen::Ref<const Eigen::RowVectorXd>& C,
+                   double D);
+
+    /**
+     * @brief Sets all states to zero (body at rest before the first step).
+     */
+    void Reset();
+
+    /**
+     * @brief Advances the states to time t and computes the radiation force.
+     *
+     * The first call after Reset() only records the velocity, with all states at zero.
+     *
+     * @param t current time, must be larger than the time of the previous call
+     * @param velocity num_dofs velocities at time t
+     *
+     * @return num_dofs radiation damping force at time t, valid until the next call
+     */
+    const Eigen::VectorXd& Advance(double t, const Eigen::Ref<const Eigen::VectorXd>& velocity);
+
+    /**
+     * @brief Number of kernels with a realization.
+     */
+    int GetNumKernels() const { return static_cast<int>(kernels_.size()); }
+
+    /**
+     * @brief Total number of states of all kernels.
+     */
+    int GetNumStates() const { return static_cast<int>(states_.size()); }
+
+  private:
+    struct Kernel {
+        int row;
+        int col;
+        int offset;  ///< first state of this kernel in states_
+        Eigen::MatrixXd A;
+        Eigen::VectorXd B;
+        Eigen::RowVectorXd C;
+        double D;
+        // discretization for step_: x(t + h) = Ad x(t) + Bd0 u(t) + Bd1 u(t + h)
+        Eigen::MatrixXd Ad;
+        Eigen::VectorXd Bd0;
+        Eigen::VectorXd Bd1;
+    };
+
+    std::vector<Kernel> kernels_;
+    Eigen::VectorXd states_;
+    Eigen::VectorXd scratch_;   ///< work vector of the size of the largest kernel
+    Eigen::VectorXd velocity_;  ///< velocity of the previous call
+    Eigen::VectorXd force_;
+    double time_  = 0.0;
+    double step_  = 0.0;  ///< time step of the cached discretization, 0 if none
+    bool started_ = false;
+
+    /**
+     * @brief Computes the discretization of all kernels for a time step.
+     *
+     * @param h time step
+     */
+    void Discretize(double h);
+};
+
+#endif
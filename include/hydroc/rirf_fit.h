@@ -0,0 +1,59 @@
+#ifndef RIRF_FIT_H
+#define RIRF_FIT_H
+/*********************************************************************
+ * @file  rirf_fit.h
+ *
+ * @brief header file for the identification of state space models \
+ * (sums of exponentials) from sampled RIRF kernels.
+ *********************************************************************/
+#pragma once
+
+#include <Eigen/Dense>
+
+/**
+ * @brief Reduced order state space model of one RIRF kernel, K(t) ~ C exp(A t) B.
+ */
+struct RIRFKernelFit {
+    int order    = 0;    // number of states, 0 if the kernel is negligible
+    double error = 0.0;  // L2 error over the RIRF samples, relative to the reference norm (see FitRIRFKernel)
+    Eigen::MatrixXd A;
+    Eigen::VectorXd B;
+    Eigen::RowVectorXd C;
+};
+
+/**
+ * @brief Summary of the fit of one RIRF kernel, for reporting.
+ */
+struct RIRFFitSummary {
+    int row;       // DoF of the force, 0,...,6N-1
+    int col;       // DoF of the velocity, 0,...,6N-1
+    int order;     // number of states of the fitted model
+    double error;  // relative L2 error of the fitted model over the RIRF samples, see RIRFKernelFit
+};
+
+/**
+ * @brief Fits a sum of exponentials (as a real state space model) to a uniformly sampled RIRF kernel.
+ *
+ * Uses the eigensystem realization algorithm: the SVD of the Hankel matrix of the samples gives balanced realizations
+ * of increasing order, which are converted to continuous time with a matrix logarithm. The lowest order with relative
+ * error below the tolerance is returned, or the most accurate stable model up to max_order if none reaches it.
+ *
+ * Errors are relative to the L2 norm of the kernel, or to scale if that is larger. Passing the norm of the largest
+ * kernel of the system as scale bounds the error contribution of each kernel, and kernels that are negligible at that
+ * scale are dropped (order 0) instead of being fitted to numerical noise.
+ *
+ * @param samples kernel values at t = 0, dt, 2 dt, ...
+ * @param dt sampling time step
+ * @param tolerance target relative L2 error over the samples
+ * @param max_order maximum number of states
+ * @param scale minimum reference norm for the relative error
+ *
+ * @return fitted model, with its order and error
+ */
+RIRFKernelFit FitRIRFKernel(const Eigen::Ref<const Eigen::VectorXd>& samples,
+                            double dt,
+                            double tolerance,
+                            int max_order,
+                            double scale = 0.0);
+
+#endif
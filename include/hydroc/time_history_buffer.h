@@ -0,0 +1,126 @@
+#ifndef TIME_HISTORY_BUFFER_H
+#define TIME_HISTORY_BUFFER_H
+/*********************************************************************
+ * @file  time_history_buffer.h
+ *
+ * @brief header file for TimeHistoryBuffer, a circular buffer of time \
+ * stamped samples used for convolution histories.
+ *********************************************************************/
+#pragma once
+
+#include <Eigen/Dense>
+
+/**
+ * @brief Fixed-capacity circular buffer of time stamped vector samples, indexed newest first.
+ *
+ * Time stamps and values are kept in preallocated contiguous storage, so Push() and PopOldest() are O(1) and do not
+ * allocate. The capacity only grows (by doubling) if more samples are pushed than were reserved, which should not
+ * happen in steady state when the buffer is sized from the length of the convolution kernel.
+ *
+ * Values are stored column-major with one column per component, i.e. the history of each component is contiguous.
+ * Every sample is written twice (mirrored at row + capacity), so that the newest n samples are always available as one
+ * contiguous block through Window(), regardless of where the circular storage wraps around.
+ */
+class TimeHistoryBuffer {
+  public:
+    TimeHistoryBuffer() = default;
+
+    /**
+     * @brief Allocates storage for the buffer.
+     *
+     * @param width number of components in each sample (6N for the velocity of N bodies)
+     * @param capacity number of samples that can be stored before the buffer needs to grow
+     */
+    TimeHistoryBuffer(int width, int capacity);
+
+    /**
+     * @brief Discards all samples and reallocates storage.
+     *
+     * @param width number of components in each sample
+     * @param capacity number of samples that can be stored before the buffer needs to grow
+     */
+    void Reset(int width, int capacity);
+
+    /**
+     * @brief Adds a new sample, which becomes sample 0.
+     *
+     * @param t time stamp of the sample, expected to be larger than Time(0)
+     * @param values sample values, size must equal Width()
+     */
+    void Push(double t, const Eigen::Ref<const Eigen::VectorXd>& values);
+
+    /**
+     * @brief Removes the oldest sample (sample Size()-1).
+     */
+    void PopOldest();
+
+    /**
+     * @brief Number of samples currently stored.
+     */
+    int Size() const { return size_; }
+
+    /**
+     * @brief Number of samples that can be stored without reallocation.
+     */
+    int Capacity() const { return capacity_; }
+
+    /**
+     * @brief Number of components in each sample.
+     */
+    int Width() const { return static_cast<int>(values_.cols()); }
+
+    /**
+     * @brief Time stamp of a stored sample.
+     *
+     * @param i sample index, 0 is the newest sample and Size()-1 the oldest
+     *
+     * @return time stamp of sample i
+     */
+    double Time(int i) const { return times_[Physical(i)]; }
+
+    /**
+     * @brief Value of one component of a stored sample.
+     *
+     * @param i sample index, 0 is the newest sample and Size()-1 the oldest
+     * @param c component index in [0, Width())
+     *
+     * @return component c of sample i
+     */
+    double Value(int i, int c) const { return values_(Physical(i), c); }
+
+    /**
+     * @brief Newest samples as a contiguous block, without copying.
+     *
+     * Row i of the block is sample i (newest first) and column c its component c, each column is contiguous in memory.
+     * The block is invalidated by the next Push().
+     *
+     * @param n number of samples in the window, n <= Size()
+     *
+     * @return n x Width() block of the storage
+     */
+    Eigen::Block<const Eigen::MatrixXd> Window(int n) const { return values_.block(head_, 0, n, values_.cols()); }
+
+  private:
+    Eigen::VectorXd times_;   ///< time stamps, capacity_ entries
+    Eigen::MatrixXd values_;  ///< samples, 2 * capacity_ rows (mirrored) by width columns
+    int capacity_ = 0;
+    int head_     = 0;  ///< physical row of the newest sample
+    int size_     = 0;
+
+    /**
+     * @brief Maps a logical sample index (0 = newest) to a row of the storage.
+     */
+    int Physical(int i) const {
+        int p = head_ + i;
+        return p < capacity_ ? p : p - capacity_;
+    }
+
+    /**
+     * @brief Reallocates storage with a larger capacity, keeping all stored samples.
+     *
+     * @param capacity new capacity, must be larger than Size()
+     */
+    void Grow(int capacity);
+};
+
+#endif
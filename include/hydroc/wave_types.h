@@ -7,6 +7,9 @@
  * @brief header file for Wavebase and classes inheriting from WaveBase.
  *********************************************************************/
 #pragma once
+#include <hydroc/binary_cache.h>
+#include <hydroc/eta_record.h>
+#include <hydroc/free_surface_generator.h>
 #include <hydroc/h5fileinfo.h>
 #include <Eigen/Dense>
 
@@ -52,7 +55,39 @@ class WaveBase {
      * @param t the current time to get the force for
      */
     virtual Eigen::VectorXd GetForceAtTime(double t) = 0;
-    virtual WaveMode GetWaveMode()                   = 0;
+
+    /**
+     * @brief Computes the 6N dimensional force vector on hydro bodies into a caller provided buffer.
+     *
+     * Overridden by the wave classes of HydroChrono to compute the force without any allocation. The default
+     * implementation copies the result of GetForceAtTime(t).
+     *
+     * @param t the time to get the force for
+     * @param force 6N dimensional output, throws std::invalid_argument if its size is wrong
+     */
+    virtual void GetForceAtTime(double t, Eigen::Ref<Eigen::VectorXd> force);
+
+    /**
+     * @brief Computes the 6N dimensional force vectors at M times into a caller provided 6N x M block.
+     *
+     * The default implementation calls GetForceAtTime(t, force) for each column.
+     *
+     * @param times the M times to get the force for
+     * @param forces 6N x M output, column k is the force at times[k], throws std::invalid_argument if its number of
+     * columns is not M
+     */
+    virtual void GetForceAtTimes(const Eigen::Ref<const Eigen::VectorXd>& times, Eigen::Ref<Eigen::MatrixXd> forces);
+
+    virtual WaveMode GetWaveMode() = 0;
+
+    /**
+     * @brief Gets the optional groups of h5 datasets this wave model reads from HydroData.
+     *
+     * TestHydro only loads these groups, see HydroData::Require(). The default requires none.
+     *
+     * @return the optional h5 data passed to AddH5Data()
+     */
+    virtual HydroDataRequirements GetHydroDataRequirements() const { return {}; }
 };
 
 /**
@@ -74,6 +109,8 @@ class NoWave : public WaveBase {
      * @return 6N dimensional force vector (Eigen::VectorXd) from waves in NoWave case.
      */
     Eigen::VectorXd GetForceAtTime(double t) override;
+    void GetForceAtTime(double t, Eigen::Ref<Eigen::VectorXd> force) override;
+    void GetForceAtTimes(const Eigen::Ref<const Eigen::VectorXd>& times, Eigen::Ref<Eigen::MatrixXd> forces) override;
     WaveMode GetWaveMode() override { return mode_; }
 
   private:
@@ -122,6 +159,16 @@ class RegularWave : public WaveBase {
      */
     Eigen::VectorXd GetForceAtTime(double t) override;
 
+    /**
+     * @brief calculates the force from the regular wave at time t into force, without allocation.
+     */
+    void GetForceAtTime(double t, Eigen::Ref<Eigen::VectorXd> force) override;
+
+    /**
+     * @brief calculates the force from the regular wave at M times into the 6N x M block forces.
+     */
+    void GetForceAtTimes(const Eigen::Ref<const Eigen::VectorXd>& times, Eigen::Ref<Eigen::MatrixXd> forces) override;
+
     /**
      * @brief gets wave mode.
      *
@@ -129,6 +176,11 @@ class RegularWave : public WaveBase {
      */
     WaveMode GetWaveMode() override { return mode_; }
 
+    /**
+     * @brief RegularWave interpolates the excitation magnitude and phase, not the excitation IRF.
+     */
+    HydroDataRequirements GetHydroDataRequirements() const override;
+
     // user input variables
     double regular_wave_amplitude_;
     double regular_wave_omega_;
@@ -141,7 +193,7 @@ class RegularWave : public WaveBase {
      *
      * @param reg_h5_data reference to chunk of h5 data needed for RegularWave calculations
      */
-    void AddH5Data(std::vector<HydroData::RegularWaveInfo>& reg_h5_data);
+    void AddH5Data(const std::vector<HydroData::RegularWaveInfo>& reg_h5_data);
 
   private:
     unsigned int num_bodies_;
@@ -234,6 +286,18 @@ class RegularWave : public WaveBase {
 //    friend Eigen::VectorXd PiersonMoskowitzSpectrumHz(Eigen::VectorXd& f, double Hs, double Tp);
 //};
 
+/**
+ * @brief How IrregularWaves computes the excitation force at each call of GetForceAtTime.
+ */
+enum class ExcitationMode {
+    /// @brief Convolution of the excitation IRF with the free surface elevation at every call
+    convolution = 0,
+    /// @brief Force precomputed on the simulation time grid at initialization, interpolated at every call
+    precomputed = 1,
+    /// @brief Force synthesized from the wave spectrum and the h5 excitation coefficients, without the excitation IRF
+    frequencyDomain = 2
+};
+
 struct IrregularWaveParams {
     unsigned int num_bodies_;
     double simulation_dt_;
@@ -248,6 +312,9 @@ struct IrregularWaveParams {
     double peak_enhancement_factor_ = 1.0;
     bool is_normalized_             = false;
     int seed_                       = 1;
+    ExcitationMode excitation_mode_ = ExcitationMode::precomputed;
+    std::string cache_dir_;          // directory of the excitation table cache files, empty for no cache
+    bool write_wave_files_ = false;  // write spectral_densities.txt and eta.txt to the working directory
 };
 
 class IrregularWaves : public WaveBase {
@@ -256,11 +323,52 @@ class IrregularWaves : public WaveBase {
     void Initialize() override {}
 
     std::vector<double> GetSpectrum();
+
+    /**
+     * @brief Gets the free surface elevation, generated on the simulation time grid or read from the eta file.
+     *
+     * @return elevation at times 0, dt,..., simulation duration, or the samples of the eta file
+     */
     std::vector<double> GetFreeSurfaceElevation();
+
+    /**
+     * @brief Gets the times of the eta file samples, empty without an eta file.
+     */
     std::vector<double> GetEtaTimeData();
 
+    /**
+     * @brief Computes the 6N dimensional excitation force at time t.
+     *
+     * With ExcitationMode::precomputed and ExcitationMode::frequencyDomain the force is interpolated linearly in the
+     * table computed at initialization. After the simulation duration, precomputed falls back to the convolution and
+     * frequencyDomain throws.
+     *
+     * @param t time to get the force for
+     *
+     * @return 6N dimensional excitation force
+     */
     Eigen::VectorXd GetForceAtTime(double t) override;
 
+    /**
+     * @brief Computes the 6N dimensional excitation force at time t into force, without allocation.
+     */
+    void GetForceAtTime(double t, Eigen::Ref<Eigen::VectorXd> force) override;
+
+    /**
+     * @brief Computes the excitation force at M times into the 6N x M block forces.
+     *
+     * Times within the precomputed table are interpolated column by column, the others are computed as in
+     * GetForceAtTime(t, force).
+     */
+    void GetForceAtTimes(const Eigen::Ref<const Eigen::VectorXd>& times, Eigen::Ref<Eigen::MatrixXd> forces) override;
+
+    /**
+     * @brief Gets the memory used by the precomputed excitation force table.
+     *
+     * @return size of the table in bytes, 0 if the force is not precomputed
+     */
+    size_t GetExcitationTableMemory() const { return sizeof(double) * excitation_table_.size(); }
+
     /**
      * @brief overloaded function from WaveBase to get the wave mode.
      *
@@ -268,6 +376,12 @@ class IrregularWaves : public WaveBase {
      */
     WaveMode GetWaveMode() override { return mode_; }
 
+    /**
+     * @brief The excitation real and imaginary parts in ExcitationMode::frequencyDomain, the excitation IRF in the
+     * time domain modes.
+     */
+    HydroDataRequirements GetHydroDataRequirements() const override;
+
     /**
      * @brief TODO
      *
@@ -324,14 +438,17 @@ class IrregularWaves : public WaveBase {
      *
      * @param irreg_h5_data reference to chunk of h5 data needed for IrregularWave calculations
      */
-    void AddH5Data(std::vector<HydroData::IrregularWaveInfo>& irreg_h5_data, HydroData::SimulationParameters& sim_data);
+    void AddH5Data(const std::vector<HydroData::IrregularWaveInfo>& irreg_h5_data,
+                   const HydroData::SimulationParameters& sim_data);
 
   private:
     IrregularWaveParams params_;
     std::vector<double> spectrum_;
-    std::vector<double> time_data_;
-    std::vector<double> free_surface_elevation_sampled_;
-    std::vector<double> free_surface_time_sampled_;
+    EtaRecord eta_record_;                                  // eta file samples
+    FreeSurfaceElevationGenerator free_surface_generator_;  // eta from the spectrum, without an eta file
+    FreeSurfaceElevationWindow free_surface_window_;        // generated eta for the convolution in GetForceAtTime
+    double irf_time_min_ = 0.0;                             // IRF time range over all bodies
+    double irf_time_max_ = 0.0;
     bool spectrumCreated_;
 
     const WaveMode mode_ = WaveMode::irregular;
@@ -345,6 +462,15 @@ class IrregularWaves : public WaveBase {
     Eigen::VectorXd spectrum_frequencies_;
     Eigen::VectorXd spectral_densities_;
     std::string mesh_file_name_;
+    Eigen::MatrixXd excitation_table_;  // 6N x K force at times excitation_table_start_ + k * simulation_dt_
+    double excitation_table_start_ = 0.0;
+
+    /**
+     * @brief Interpolates the precomputed table at time t into force.
+     *
+     * @return false if t is out of the table (or there is no table), force is then unchanged
+     */
+    bool InterpolateExcitationTable(double t, Eigen::Ref<Eigen::VectorXd> force) const;
 
     void InitializeIRFVectors();
     void ReadEtaFromFile();
@@ -363,21 +489,54 @@ class IrregularWaves : public WaveBase {
      */
     void CalculateWidthIRF();
 
+    /**
+     * @brief Fills excitation_table_ on the simulation time grid, and prints its size.
+     *
+     * With ExcitationMode::precomputed see ConvolveExcitation(), with ExcitationMode::frequencyDomain see
+     * SynthesizeExcitation(). With a cache directory, the table is read from the cache file of GetCacheKey() if it
+     * exists, and written to it otherwise.
+     */
+    void InitializeExcitationTable();
+
+    /**
+     * @brief Evaluates the excitation convolution over the simulation duration, the time steps in parallel.
+     */
+    void ConvolveExcitation();
+
+    /**
+     * @brief Key of the excitation table cache: the library version, the parameters, the eta file contents and the
+     * h5 data the table is computed from.
+     */
+    CacheKey GetCacheKey() const;
+
+    /**
+     * @brief Synthesizes the excitation force over the simulation duration from the wave spectrum.
+     *
+     * Each spectral component contributes sqrt(2 S df) Re(X(omega) exp(i (omega t + phase))), with the same amplitudes
+     * and random phases as the free surface elevation, and X the h5 excitation coefficients (re, im) interpolated
+     * linearly in frequency (end values outside of the h5 frequencies). The sums are evaluated with FFTs by
+     * HarmonicSynthesis, and the ramp is applied to the force.
+     */
+    void SynthesizeExcitation();
+
     /**
      * @brief Calculates the component of force from Convolution integral for specified body, dof, time.
      *
      * The discretization uses the time series of the of the IRF relative to the current time step.
-     * Linear interpolation is done for the free surface elevation if time_sim-time_irf is between two
-     * values of the time series of the precomputed free surface elevation.
-     * Trapezoidal integration is used to compute the force.
+     * The free surface elevation at time_sim-time_irf is interpolated linearly between the samples generated on the
+     * simulation time grid, or between the samples of the eta file (zero outside of the file, see EtaRecord).
+     * Trapezoidal integration is used to compute the force. With an eta file the time itself must be within the
+     * record, up to one time step past its end: the zero elevation only pads the IRF span at the ends of the record,
+     * std::runtime_error is thrown past them.
      *
      * @param body which body currently calculating for
      * @param dof which degree of freedom to calculate force value for
      * @param time the time to compute force for
+     * @param window generated free surface elevation samples, reused between calls with increasing times
      *
      * @return value of force vector at t time in component corresponding to body and dof
      */
-    double ExcitationConvolution(int body, int dof, double time);
+    double ExcitationConvolution(int body, int dof, double time, FreeSurfaceElevationWindow& window) const;
 };
 
 /**
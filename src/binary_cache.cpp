@@ -0,0 +1,153 @@
+/*********************************************************************
+ * @file  binary_cache.cpp
+ *
+ * @brief implementation file for CacheKey and the cache files.
+ *********************************************************************/
+#include <hydroc/binary_cache.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+#ifndef HYDROCHRONO_VERSION
+#define HYDROCHRONO_VERSION "unknown"
+#endif
+
+namespace {
+// file layout: magic, key, number of matrices, then rows, cols and column-major values of each matrix
+constexpr char kCacheMagic[8]        = {'H', 'C', 'C', 'A', 'C', 'H', 'E', '1'};
+constexpr std::uint64_t kFnvOffset   = 14695981039346656037ULL;
+constexpr std::uint64_t kFnvPrime    = 1099511628211ULL;
+constexpr std::uint64_t kMaxMatrices = 1024;
+
+template <typename T>
+bool ReadValue(std::istream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+template <typename T>
+void WriteValue(std::ostream& out, T value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+}  // namespace
+
+CacheKey::CacheKey() : hash_(kFnvOffset) {
+    Add(std::string(HYDROCHRONO_VERSION));
+    Add(kCacheMagic, sizeof(kCacheMagic));
+}
+
+CacheKey& CacheKey::Add(const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; i++) {
+        hash_ = (hash_ ^ bytes[i]) * kFnvPrime;
+    }
+    return *this;
+}
+
+CacheKey& CacheKey::Add(const std::string& value) {
+    AddValue(static_cast<std::uint64_t>(value.size()));
+    return Add(value.data(), value.size());
+}
+
+CacheKey& CacheKey::Add(const Eigen::Ref<const Eigen::MatrixXd>& value) {
+    AddValue(static_cast<std::int64_t>(value.rows()));
+    AddValue(static_cast<std::int64_t>(value.cols()));
+    for (Eigen::Index col = 0; col < value.cols(); col++) {
+        Add(value.col(col).data(), sizeof(double) * value.rows());
+    }
+    return *this;
+}
+
+CacheKey& CacheKey::AddFile(const std::string& file_name) {
+    std::ifstream file(file_name, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("CacheKey: unable to open file " + file_name + ".");
+    }
+    std::vector<char> buffer(1 << 16);
+    while (file.read(buffer.data(), buffer.size()) || file.gcount() > 0) {
+        Add(buffer.data(), file.gcount());
+    }
+    return *this;
+}
+
+std::string CacheKey::GetHex() const {
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash_));
+    return hex;
+}
+
+bool ReadCacheFile(const std::string& file_name, std::uint64_t key, std::vector<Eigen::MatrixXd>& matrices) {
+    std::ifstream file(file_name, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+    const auto file_size = static_cast<std::uint64_t>(file.tellg());
+    file.seekg(0);
+
+    char magic[sizeof(kCacheMagic)];
+    std::uint64_t file_key = 0;
+    std::uint64_t count    = 0;
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, kCacheMagic, sizeof(magic)) != 0 ||
+        !ReadValue(file, file_key) || file_key != key || !ReadValue(file, count) || count > kMaxMatrices) {
+        return false;
+    }
+
+    std::vector<Eigen::MatrixXd> result(count);
+    for (auto& matrix : result) {
+        std::int64_t rows = 0;
+        std::int64_t cols = 0;
+        if (!ReadValue(file, rows) || !ReadValue(file, cols) || rows < 0 || cols < 0) {
+            return false;
+        }
+        // sizes beyond the end of the file are a damaged file, not an allocation to attempt
+        const auto remaining = file_size - static_cast<std::uint64_t>(file.tellg());
+        if (rows > 0 && static_cast<std::uint64_t>(cols) > remaining / sizeof(double) / rows) {
+            return false;
+        }
+        matrix.resize(rows, cols);
+        if (!file.read(reinterpret_cast<char*>(matrix.data()), sizeof(double) * matrix.size())) {
+            return false;
+        }
+    }
+
+    matrices = std::move(result);
+    return true;
+}
+
+void WriteCacheFile(const std::string& file_name, std::uint64_t key, const std::vector<Eigen::MatrixXd>& matrices) {
+    std::error_code error;
+    const std::filesystem::path path(file_name);
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), error);
+    }
+
+    // unique temporary name, several processes can write the same entry
+    std::random_device random;
+    const std::string temp_name = file_name + "." + std::to_string(random()) + ".tmp";
+    {
+        std::ofstream file(temp_name, std::ios::binary);
+        file.write(kCacheMagic, sizeof(kCacheMagic));
+        WriteValue(file, key);
+        WriteValue(file, static_cast<std::uint64_t>(matrices.size()));
+        for (const auto& matrix : matrices) {
+            WriteValue(file, static_cast<std::int64_t>(matrix.rows()));
+            WriteValue(file, static_cast<std::int64_t>(matrix.cols()));
+            file.write(reinterpret_cast<const char*>(matrix.data()), sizeof(double) * matrix.size());
+        }
+        if (!file) {
+            std::cerr << "Unable to write cache file " << file_name << "." << std::endl;
+            file.close();
+            std::filesystem::remove(temp_name, error);
+            return;
+        }
+    }
+    std::filesystem::rename(temp_name, path, error);
+    if (error) {
+        std::cerr << "Unable to write cache file " << file_name << ": " << error.message() << "." << std::endl;
+        std::filesystem::remove(temp_name, error);
+    }
+}
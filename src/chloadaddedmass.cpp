@@ -5,6 +5,7 @@
  *********************************************************************/
 #include <hydroc/chloadaddedmass.h>
 
+#include <stdexcept>
 #include <utility>
 
 #include "chrono/physics/ChBody.h"
@@ -20,8 +21,21 @@ ChLoadAddedMass::ChLoadAddedMass(const std::vector<HydroData::BodyInfo>& user_h5
         infinite_added_mass.block(i * 6, 0, 6, nBodies * 6) = user_h5_body_data[i].inf_added_mass;
     }
 
-    // initialize added mass matrix for whole system
-    infinite_added_mass_system = infinite_added_mass;
+    grouped_w.setZero(6 * nBodies);
+    grouped_Mw.setZero(6 * nBodies);
+
+    linear_restoring.setZero(6 * nBodies, 6 * nBodies);
+    for (int i = 0; i < nBodies; i++) {
+        linear_restoring.block(i * 6, i * 6, 6, 6) = user_h5_body_data[i].lin_matrix;
+    }
+}
+
+void ChLoadAddedMass::SetRadiationDamping(const ChMatrixDynamic<double>& damping) {
+    const auto size = infinite_added_mass.rows();
+    if (damping.size() > 0 && (damping.rows() != size || damping.cols() != size)) {
+        throw std::invalid_argument("ChLoadAddedMass: radiation damping does not match the hydro bodies.");
+    }
+    radiation_damping = damping;
 }
 
 void ChLoadAddedMass::ComputeJacobian(ChState* state_x,       ///< state position to evaluate jacobians
@@ -30,45 +44,59 @@ void ChLoadAddedMass::ComputeJacobian(ChState* state_x,       ///< state positio
                                       ChMatrixRef mR,         ///< result dQ/dv
                                       ChMatrixRef mM          ///< result dQ/da
 ) {
-    // The following ensures that the added mass matrix matches the size of the ChSystem mass matrix. It is necessary
-    // for systems that have both hydro and non-hydro bodies when adding a system-wide load.
-    // @todo if possible, remove hack by using initialiazer function called AFTER the ChSystem is assembled.
+    // The Jacobians are 6N x 6N, over the variables of the hydro bodies only: Chrono stamps them at the offsets of
+    // these variables in the system matrices, wherever the bodies are in the system.
 
-    // get mass matrix size
-    auto mmrows = system->GetNcoords_w();  // number of rows in system mass matrix
-    // check if ChSystem mass matrix size different from added mass matrix size
-    if (mmrows != infinite_added_mass_system.rows() && mmrows > 0) {
-        // initialize/update system matrix;
-        infinite_added_mass_system.setZero(mmrows, mmrows);
-        auto amrows                                            = infinite_added_mass.rows();
-        infinite_added_mass_system.block(0, 0, amrows, amrows) = infinite_added_mass;
-    }
     // set mass matrix here
-    jacobians->M = infinite_added_mass_system;
+    jacobians->M = infinite_added_mass;
 
-    // R gyroscopic damping matrix terms (6Nx6N)
-    // 0 for added mass
-    jacobians->R.setZero();
+    // R damping matrix terms (6Nx6N), R = -dQ/dv
+    // 0 for added mass, instantaneous radiation damping if set. The angular velocities of the state are in the body
+    // frame, the damping is applied to absolute ones, the same for small rotations.
+    jacobians->R.setZero(infinite_added_mass.rows(), infinite_added_mass.cols());
+    if (radiation_damping.size() > 0) {
+        const auto rows                      = radiation_damping.rows();
+        jacobians->R.block(0, 0, rows, rows) = radiation_damping;
+    }
 
-    // K inertial stiffness matrix terms (6Nx6N)
-    // 0 for added mass
-    jacobians->K.setZero();
+    // K stiffness matrix terms (6Nx6N), K = -dQ/dx
+    // 0 for added mass, hydrostatic restoring rho g lin_matrix if enabled. The force model displaces the bodies in
+    // Euler123 angles, which match the rotation increments of the state for small rotations.
+    jacobians->K.setZero(infinite_added_mass.rows(), infinite_added_mass.cols());
+    if (hydrostatic_rho > 0.0) {
+        const double gg = system->Get_G_acc().Length();
+        const auto rows = linear_restoring.rows();
+        jacobians->K.block(0, 0, rows, rows) = (hydrostatic_rho * gg) * linear_restoring;
+    }
 }
 
 void ChLoadAddedMass::LoadIntLoadResidual_Mv(ChVectorDynamic<>& R, const ChVectorDynamic<>& w, const double c) {
     if (!this->jacobians) return;
 
-    // if (!loadable->IsSubBlockActive(0))
-    //	return;
+    // R += c*M*w, with M the added mass block of the hydro bodies: gather w at the body offsets, multiply, scatter
+    int offset = 0;
+    for (const auto& loadable : loadables) {
+        for (int i = 0; i < loadable->GetSubBlocks(); i++) {
+            const int size = loadable->GetSubBlockSize(i);
+            if (loadable->IsSubBlockActive(i)) {
+                grouped_w.segment(offset, size) = w.segment(loadable->GetSubBlockOffset(i), size);
+            } else {
+                grouped_w.segment(offset, size).setZero();
+            }
+            offset += size;
+        }
+    }
+
+    grouped_Mw.noalias() = c * jacobians->M * grouped_w;
 
-    // R+=c*M*a
-    // segment gives the chunk of vector starting at the first argument, and going for as many elements as the second
-    // argument... in this case, segment gets the 3vector starting at the 0th DOF's offset (ie 0)
-    // R.segment(loadable->GetSubBlockOffset(0), 3) += c * (this->mass * (a_x + chrono::Vcross(a_w,
-    // this->c_m))).eigen();
-    // in this case, segment gets the 3vector starting at the 0th DOF's + 3 offset (ie 3)
-    // R.segment(loadable->GetSubBlockOffset(0) + 3, 3) += c * (this->mass * chrono::Vcross(this->c_m, a_x) + this->I *
-    // a_w).eigen();
-    // since R is a vector, we can probably just do R += C*M*a with no need to separate w into a_x and a_w above
-    R += c * jacobians->M * w;
-}
\ No newline at end of file
+    offset = 0;
+    for (const auto& loadable : loadables) {
+        for (int i = 0; i < loadable->GetSubBlocks(); i++) {
+            const int size = loadable->GetSubBlockSize(i);
+            if (loadable->IsSubBlockActive(i)) {
+                R.segment(loadable->GetSubBlockOffset(i), size) += grouped_Mw.segment(offset, size);
+            }
+            offset += size;
+        }
+    }
+}
@@ -0,0 +1,63 @@
+/*********************************************************************
+ * @file  chloadhydroforces.cpp
+ *
+ * @brief implementation file for the hydro force chload class.
+ *********************************************************************/
+#include <hydroc/chloadhydroforces.h>
+#include <hydroc/hydro_forces.h>
+
+#include <stdexcept>
+
+namespace {
+const int kStatePerBody = 7;  // position, rotation quaternion
+const int kDofPerBody   = 6;
+}  // namespace
+
+ChLoadHydroForces::ChLoadHydroForces(TestHydro* hydro_forces, std::vector<std::shared_ptr<ChLoadable>>& bodies)
+    : ChLoadCustomMultiple(bodies), hydro_forces_(hydro_forces) {
+    if (hydro_forces_ == nullptr) {
+        throw std::invalid_argument("ChLoadHydroForces: TestHydro is null.");
+    }
+    positions_.setZero(kDofPerBody * bodies.size());
+    velocities_.setZero(kDofPerBody * bodies.size());
+}
+
+void ChLoadHydroForces::ComputeQ(ChState* state_x, ChStateDelta* state_w) {
+    const int num_bodies = static_cast<int>(loadables.size());
+    if (state_x == nullptr || state_w == nullptr || state_x->size() != kStatePerBody * num_bodies ||
+        state_w->size() != kDofPerBody * num_bodies) {
+        throw std::invalid_argument("ChLoadHydroForces: states do not match the hydro bodies.");
+    }
+
+    for (int b = 0; b < num_bodies; b++) {
+        const int x_offset = kStatePerBody * b;
+        const int offset   = kDofPerBody * b;
+        const ChQuaternion<> rotation((*state_x)(x_offset + 3), (*state_x)(x_offset + 4), (*state_x)(x_offset + 5),
+                                      (*state_x)(x_offset + 6));
+        const ChVector<> euler = rotation.Q_to_Euler123();
+        const ChVector<> angular_velocity =
+            rotation.Rotate(ChVector<>((*state_w)(offset + 3), (*state_w)(offset + 4), (*state_w)(offset + 5)));
+        for (int ii = 0; ii < 3; ii++) {
+            positions_(offset + ii)      = (*state_x)(x_offset + ii);
+            positions_(offset + ii + 3)  = euler[ii];
+            velocities_(offset + ii)     = (*state_w)(offset + ii);
+            velocities_(offset + ii + 3) = angular_velocity[ii];
+        }
+    }
+
+    const std::vector<double>& force = hydro_forces_->ComputeTotalForce(positions_, velocities_);
+
+    // forces in the absolute frame, torques in the body frame
+    for (int b = 0; b < num_bodies; b++) {
+        const int x_offset = kStatePerBody * b;
+        const int offset   = kDofPerBody * b;
+        const ChQuaternion<> rotation((*state_x)(x_offset + 3), (*state_x)(x_offset + 4), (*state_x)(x_offset + 5),
+                                      (*state_x)(x_offset + 6));
+        const ChVector<> torque =
+            rotation.RotateBack(ChVector<>(force[offset + 3], force[offset + 4], force[offset + 5]));
+        for (int ii = 0; ii < 3; ii++) {
+            load_Q(offset + ii)     = force[offset + ii];
+            load_Q(offset + ii + 3) = torque[ii];
+        }
+    }
+}
@@ -0,0 +1,176 @@
+/*********************************************************************
+ * @file  eta_record.cpp
+ *
+ * @brief implementation file for EtaRecord.
+ *********************************************************************/
+#include <hydroc/eta_record.h>
+#include <hydroc/harmonic_synthesis.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+// binary layout, native byte order: magic, format version, value size (4 or 8), start time, time step, number of
+// samples, then the elevations from byte kBinaryHeaderSize (aligned for float64)
+constexpr char kBinaryMagic[8]            = {'H', 'C', 'E', 'T', 'A', 'R', 'E', 'C'};
+constexpr std::uint32_t kBinaryVersion    = 1;
+constexpr std::size_t kBinaryHeaderSize   = 40;
+constexpr double kUniformSpacingTolerance = 1e-6;
+
+bool IsBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+template <typename T>
+T ReadHeaderValue(const char* data, std::size_t offset) {
+    T value;
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+}  // namespace
+
+EtaRecord EtaRecord::Read(const std::string& file_name) {
+    auto file              = MappedFile::Open(file_name);
+    const char* data       = file->GetData();
+    const std::size_t size = file->GetSize();
+
+    EtaRecord record;
+    if (size >= kBinaryHeaderSize && std::memcmp(data, kBinaryMagic, sizeof(kBinaryMagic)) == 0) {
+        const auto version    = ReadHeaderValue<std::uint32_t>(data, 8);
+        const auto value_size = ReadHeaderValue<std::uint32_t>(data, 12);
+        record.start_time_    = ReadHeaderValue<double>(data, 16);
+        record.time_step_     = ReadHeaderValue<double>(data, 24);
+        record.size_          = static_cast<std::size_t>(ReadHeaderValue<std::uint64_t>(data, 32));
+        if (version != kBinaryVersion || (value_size != 4 && value_size != 8) || !(record.time_step_ > 0.0) ||
+            (size - kBinaryHeaderSize) % value_size != 0 || (size - kBinaryHeaderSize) / value_size != record.size_) {
+            throw std::runtime_error("Invalid binary eta file " + file_name + ".");
+        }
+
+        // elevations used in place, the record keeps the mapping
+        if (value_size == 4) {
+            record.single_values_ = reinterpret_cast<const float*>(data + kBinaryHeaderSize);
+        } else {
+            record.double_values_ = reinterpret_cast<const double*>(data + kBinaryHeaderSize);
+        }
+        record.storage_ = file;
+        record.uniform_ = true;
+        record.mapped_  = true;
+    } else {
+        // "time : eta" lines, blank lines are skipped
+        auto times  = std::make_shared<std::vector<double>>();
+        auto values = std::make_shared<std::vector<double>>();
+        times->reserve(size / 16);
+        values->reserve(size / 16);
+        const char* end = size > 0 ? data + size : data;
+        int line        = 1;
+        for (const char* p = data; p < end; p++, line++) {
+            while (p < end && IsBlank(*p)) {
+                p++;
+            }
+            if (p == end || *p == '\n') {
+                continue;
+            }
+
+            double time = 0.0;
+            double eta  = 0.0;
+            auto parsed = std::from_chars(p, end, time);
+            p           = parsed.ptr;
+            while (p < end && IsBlank(*p)) {
+                p++;
+            }
+            bool valid = parsed.ec == std::errc() && p < end && *p == ':';
+            if (valid) {
+                p++;
+                while (p < end && IsBlank(*p)) {
+                    p++;
+                }
+                parsed = std::from_chars(p, end, eta);
+                p      = parsed.ptr;
+                while (p < end && IsBlank(*p)) {
+                    p++;
+                }
+                valid = parsed.ec == std::errc() && (p == end || *p == '\n');
+            }
+            if (!valid) {
+                throw std::runtime_error("Could not parse line " + std::to_string(line) + " of " + file_name + ".");
+            }
+            if (!times->empty() && !(time > times->back())) {
+                throw std::runtime_error("Eta file " + file_name + ": time is not increasing at line " +
+                                         std::to_string(line) + ".");
+            }
+            times->push_back(time);
+            values->push_back(eta);
+        }
+
+        record.size_          = values->size();
+        record.double_values_ = values->data();
+        record.storage_       = values;
+        record.times_         = times;
+        record.DetectUniformSpacing();
+    }
+
+    if (record.size_ < 2) {
+        throw std::runtime_error("Eta file " + file_name + " has less than two samples.");
+    }
+    return record;
+}
+
+void EtaRecord::WriteBinary(const std::string& file_name,
+                            double start_time,
+                            double time_step,
+                            const std::vector<double>& elevations,
+                            bool single_precision) {
+    if (!(time_step > 0.0)) {
+        throw std::invalid_argument("EtaRecord: the time step of a binary eta file must be positive.");
+    }
+    std::ofstream file(file_name, std::ios::binary);
+    const std::uint32_t value_size = single_precision ? 4 : 8;
+    const auto count               = static_cast<std::uint64_t>(elevations.size());
+    file.write(kBinaryMagic, sizeof(kBinaryMagic));
+    file.write(reinterpret_cast<const char*>(&kBinaryVersion), sizeof(kBinaryVersion));
+    file.write(reinterpret_cast<const char*>(&value_size), sizeof(value_size));
+    file.write(reinterpret_cast<const char*>(&start_time), sizeof(start_time));
+    file.write(reinterpret_cast<const char*>(&time_step), sizeof(time_step));
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    if (single_precision) {
+        std::vector<float> values(elevations.begin(), elevations.end());
+        file.write(reinterpret_cast<const char*>(values.data()), sizeof(float) * values.size());
+    } else {
+        file.write(reinterpret_cast<const char*>(elevations.data()), sizeof(double) * elevations.size());
+    }
+    if (!file) {
+        throw std::runtime_error("Unable to write eta file " + file_name + ".");
+    }
+}
+
+double EtaRecord::GetElevationAt(double t) const {
+    if (size_ < 2 || !(t >= GetTime(0)) || t > GetTime(size_ - 1)) {
+        return 0.0;
+    }
+
+    std::size_t idx = 0;
+    if (uniform_) {
+        idx = std::min(static_cast<std::size_t>((t - start_time_) / time_step_), size_ - 2);
+    } else {
+        idx = std::upper_bound(times_->begin(), times_->end(), t) - times_->begin() - 1;
+        idx = std::min(idx, size_ - 2);
+    }
+    const double t1 = GetTime(idx);
+    const double t2 = GetTime(idx + 1);
+    const double w2 = (t - t1) / (t2 - t1);
+    return (1.0 - w2) * GetElevation(idx) + w2 * GetElevation(idx + 1);
+}
+
+void EtaRecord::DetectUniformSpacing() {
+    uniform_ = times_->size() >= 2 &&
+               IsUniformlySpaced(Eigen::Map<const Eigen::VectorXd>(times_->data(), times_->size()),
+                                 kUniformSpacingTolerance);
+    if (uniform_) {
+        start_time_ = times_->front();
+        time_step_  = (times_->back() - times_->front()) / (times_->size() - 1);
+    }
+}
@@ -0,0 +1,109 @@
+/*********************************************************************
+ * @file  free_surface_generator.cpp
+ *
+ * @brief implementation file for FreeSurfaceElevationGenerator and \
+ * FreeSurfaceElevationWindow.
+ *********************************************************************/
+#include <hydroc/free_surface_generator.h>
+
+#include <algorithm>
+#include <complex>
+#include <stdexcept>
+
+FreeSurfaceElevationGenerator::FreeSurfaceElevationGenerator(const std::vector<double>& amplitudes,
+                                                             const std::vector<double>& omegas,
+                                                             const std::vector<double>& phases,
+                                                             double dt,
+                                                             double ramp_duration,
+                                                             int chunk_size)
+    : dt_(dt), ramp_duration_(ramp_duration), chunk_size_(chunk_size) {
+    if (omegas.size() != amplitudes.size() || phases.size() != amplitudes.size()) {
+        throw std::invalid_argument("FreeSurfaceElevationGenerator: amplitudes, omegas and phases differ in size.");
+    }
+    if (dt_ <= 0.0 || chunk_size_ < 1) {
+        throw std::invalid_argument("FreeSurfaceElevationGenerator: requires a positive time step and chunk size.");
+    }
+
+    amplitudes_  = Eigen::Map<const Eigen::ArrayXd>(amplitudes.data(), amplitudes.size());
+    omegas_      = Eigen::Map<const Eigen::ArrayXd>(omegas.data(), omegas.size());
+    phases_      = Eigen::Map<const Eigen::ArrayXd>(phases.data(), phases.size());
+    rotation_re_ = (omegas_ * dt_).cos();
+    rotation_im_ = (omegas_ * dt_).sin();
+
+    if (IsUniformlySpaced(omegas_.matrix())) {
+        const int last       = static_cast<int>(omegas_.size()) - 1;
+        const double d_omega = (omegas_[last] - omegas_[0]) / last;
+        synthesis_           = std::make_shared<const HarmonicSynthesis>(omegas_.size(), omegas_[0], d_omega, dt_);
+        coefficients_.resize(omegas_.size(), 1);
+        for (int k = 0; k < omegas_.size(); k++) {
+            coefficients_(k, 0) = std::polar(amplitudes_[k], phases_[k]);
+        }
+    }
+}
+
+void FreeSurfaceElevationGenerator::Generate(std::int64_t first, int count, double* eta) const {
+    // the ramp is zero up to t = 0
+    int begin = 0;
+    if (ramp_duration_ > 0.0 && first <= 0) {
+        begin = static_cast<int>(std::min<std::int64_t>(1 - first, count));
+        std::fill(eta, eta + begin, 0.0);
+    }
+    if (begin == count) {
+        return;
+    }
+
+    if (synthesis_) {
+        Eigen::Map<Eigen::VectorXd>(eta + begin, count - begin) =
+            synthesis_->Synthesize(coefficients_, static_cast<double>(first + begin) * dt_, count - begin);
+    } else {
+        Eigen::ArrayXd z_re(amplitudes_.size());
+        Eigen::ArrayXd z_im(amplitudes_.size());
+        Eigen::ArrayXd next_re(amplitudes_.size());
+        for (int start = begin; start < count; start += chunk_size_) {
+            const int size = std::min(chunk_size_, count - start);
+
+            // exact phasors at the start of the chunk, then the recurrence
+            const double t_start = static_cast<double>(first + start) * dt_;
+            z_re                 = amplitudes_ * (omegas_ * t_start + phases_).cos();
+            z_im                 = amplitudes_ * (omegas_ * t_start + phases_).sin();
+            for (int n = start; n < start + size; n++) {
+                eta[n]  = z_re.sum();
+                next_re = z_re * rotation_re_ - z_im * rotation_im_;
+                z_im    = z_re * rotation_im_ + z_im * rotation_re_;
+                z_re.swap(next_re);
+            }
+        }
+    }
+
+    if (ramp_duration_ > 0.0) {
+        for (int n = begin; n < count; n++) {
+            eta[n] *= std::min(static_cast<double>(first + n) * dt_ / ramp_duration_, 1.0);
+        }
+    }
+}
+
+const double* FreeSurfaceElevationWindow::GetSamples(const FreeSurfaceElevationGenerator& generator,
+                                                     std::int64_t first,
+                                                     std::int64_t last) {
+    const auto size = static_cast<std::int64_t>(samples_.size());
+    if (first >= first_ && last < first_ + size) {
+        return samples_.data() + (first - first_);
+    }
+
+    // requested range and one chunk ahead, keeping the samples already generated from first on
+    const int count = static_cast<int>(last - first + 1) + generator.GetChunkSize();
+    int kept        = 0;
+    if (first >= first_ && first < first_ + size) {
+        kept = static_cast<int>(first_ + size - first);
+        std::copy(samples_.begin() + (first - first_), samples_.end(), samples_.begin());
+    }
+    samples_.resize(count);
+    generator.Generate(first + kept, count - kept, samples_.data() + kept);
+    first_ = first;
+    return samples_.data();
+}
+
+void FreeSurfaceElevationWindow::Clear() {
+    samples_.clear();
+    first_ = 0;
+}
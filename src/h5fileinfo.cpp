@@ -9,9 +9,180 @@
 #include <hydroc/h5fileinfo.h>
 #include <filesystem>  // std::filesystem::absolute
 
+#ifdef _OPENMP
+    #include <omp.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+
 using namespace chrono;  // TODO narrow this using namespace to specify what we use from chrono or put chrono:: in front
                          // of it all?
 
+namespace {
+// upper bound of the number of values buffered while reading a dataset (512 kB)
+const hsize_t kMaxBufferValues = 65536;
+
+// serializes the HDF5 calls of all threads, the library is not thread safe
+std::mutex& GetH5Mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+// h5 file opened and closed under the HDF5 lock
+std::shared_ptr<H5::H5File> OpenH5File(const std::string& file_name) {
+    std::lock_guard<std::mutex> lock(GetH5Mutex());
+    return std::shared_ptr<H5::H5File>(new H5::H5File(file_name, H5F_ACC_RDONLY), [](H5::H5File* file) {
+        std::lock_guard<std::mutex> lock(GetH5Mutex());
+        delete file;
+    });
+}
+
+// read of one dataset: holds the HDF5 lock from construction, except while the values read are processed, and times
+// the HDF5 calls and the processing (not the waits for the lock)
+class DatasetRead {
+  public:
+    explicit DatasetRead(const std::string& name) : lock_(GetH5Mutex()), start_(Clock::now()) { timing_.name = name; }
+
+    // releases the lock to process the values read so far
+    void Release() {
+        timing_.read_ms += ElapsedMs();
+        lock_.unlock();
+        start_ = Clock::now();
+    }
+
+    // takes the lock back after processing
+    void Acquire() {
+        timing_.process_ms += ElapsedMs();
+        lock_.lock();
+        start_ = Clock::now();
+    }
+
+    // adds the timing of the dataset, under the lock
+    void Finish(std::size_t num_values, std::vector<H5DatasetTiming>& timings) {
+        timing_.read_ms += ElapsedMs();
+        timing_.num_values = num_values;
+        timings.push_back(timing_);
+    }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+    std::unique_lock<std::mutex> lock_;
+    Clock::time_point start_;
+    H5DatasetTiming timing_;
+
+    double ElapsedMs() const { return std::chrono::duration<double, std::milli>(Clock::now() - start_).count(); }
+};
+
+// runs task(b) for every body on num_threads OpenMP threads, rethrows the first exception once all are done
+template <typename Task>
+void ForEachBody(int num_bodies, int num_threads, const Task& task) {
+    std::exception_ptr error;
+    std::mutex error_mutex;
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic) if (num_threads > 1)
+    for (int b = 0; b < num_bodies; b++) {
+        try {
+            task(b);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+// reads the hyperslab of the dataset at start with the given counts into the contiguous buffer (HDF5 then copies it
+// straight from the file), resized to the number of values
+void ReadHyperslab(H5::DataSet& dataset,
+                   H5::DataSpace& filespace,
+                   const hsize_t* start,
+                   const hsize_t* count,
+                   Eigen::VectorXd& buffer) {
+    const int rank = filespace.getSimpleExtentNdims();
+    hsize_t size   = 1;
+    for (int d = 0; d < rank; d++) {
+        size *= count[d];
+    }
+    buffer.resize(size);
+    filespace.selectHyperslab(H5S_SELECT_SET, count, start);
+    const H5::DataSpace memspace(1, &size);
+    dataset.read(buffer.data(), H5::PredType::NATIVE_DOUBLE, memspace, filespace);
+}
+
+// reads a whole dataset of rank up to 4 into the column-major storage of an Eigen vector, matrix or tensor of the same
+// dimensions, scaled, with a bounded buffer instead of a copy of the dataset. The lock of read is released while each
+// block read is reordered.
+void ReadColumnMajor(H5::DataSet& dataset,
+                     H5::DataSpace& filespace,
+                     int rank,
+                     const hsize_t* dims,
+                     double* data,
+                     double scale,
+                     DatasetRead& read) {
+    hsize_t total    = 1;
+    int num_non_unit = 0;
+    for (int d = 0; d < rank; d++) {
+        total *= dims[d];
+        num_non_unit += dims[d] > 1 ? 1 : 0;
+    }
+    if (total == 0) {
+        return;
+    }
+
+    // with at most one dimension larger than 1 the row-major and column-major layouts are the same, read in place
+    if (num_non_unit <= 1) {
+        dataset.read(data, H5::PredType::NATIVE_DOUBLE, filespace, filespace);
+        if (scale != 1.0) {
+            read.Release();
+            Eigen::Map<Eigen::VectorXd>(data, total) *= scale;
+            read.Acquire();
+        }
+        return;
+    }
+
+    // h5 data is row-major: each line along the last dimension is contiguous in the file, and goes to memory with a
+    // stride of the product of the other dimensions, from the column-major offset of its first element. Lines are
+    // read in blocks along the second to last dimension, as many as fit in the buffer.
+    const hsize_t length    = dims[rank - 1];
+    const hsize_t num_lines = dims[rank - 2];
+    const hsize_t stride    = total / length;
+    const hsize_t num_outer = stride / num_lines;  // lines of the other dimensions, column-major offsets
+    const hsize_t block     = std::clamp<hsize_t>(kMaxBufferValues / length, 1, num_lines);
+    Eigen::VectorXd buffer;
+    std::array<hsize_t, 4> start = {0, 0, 0, 0};
+    std::array<hsize_t, 4> count = {1, 1, 1, 1};
+    count[rank - 1]              = length;
+    for (hsize_t outer = 0; outer < num_outer; outer++) {
+        hsize_t rest = outer;
+        for (int d = 0; d < rank - 2; d++) {
+            start[d] = rest % dims[d];
+            rest /= dims[d];
+        }
+        for (hsize_t first = 0; first < num_lines; first += block) {
+            start[rank - 2] = first;
+            count[rank - 2] = std::min(block, num_lines - first);
+            ReadHyperslab(dataset, filespace, start.data(), count.data(), buffer);
+            read.Release();
+            for (hsize_t line = 0; line < count[rank - 2]; line++) {
+                const hsize_t offset = outer + num_outer * (first + line);
+                Eigen::Map<Eigen::VectorXd, 0, Eigen::InnerStride<>>(data + offset, length,
+                                                                     Eigen::InnerStride<>(stride)) =
+                    scale * buffer.segment(line * length, length);
+            }
+            read.Acquire();
+        }
+    }
+}
+}  // namespace
+
 H5FileInfo::H5FileInfo(std::string file, int num_bod) {
     h5_file_name_ = file;
     num_bodies_   = num_bod;
@@ -23,93 +194,127 @@ H5FileInfo::H5FileInfo(std::string file, int num_bod) {
     }
 }
 
-HydroData H5FileInfo::ReadH5Data() {
+HydroData H5FileInfo::ReadH5Data(const HydroDataRequirements& requirements) {
+    timings_.clear();
     // open file with read only access
-    H5::H5File userH5File(h5_file_name_, H5F_ACC_RDONLY);
+    auto userH5File = OpenH5File(h5_file_name_);
     HydroData data_to_init;
     data_to_init.resize(num_bodies_);
 
     // simparams first
-    InitScalar(userH5File, "simulation_parameters/rho", data_to_init.sim_data_.rho);
-    InitScalar(userH5File, "simulation_parameters/g", data_to_init.sim_data_.g);
-    InitScalar(userH5File, "simulation_parameters/water_depth", data_to_init.sim_data_.water_depth);
-    double rho = data_to_init.sim_data_.rho;
-    double g   = data_to_init.sim_data_.g;
-
-    // for each body things
-    for (int i = 0; i < num_bodies_; i++) {
-        // body data
-        data_to_init.body_data_[i].body_name = "body" + std::to_string(i + 1);
-        std::string bodyName                 = data_to_init.body_data_[i].body_name;  // shortcut for reading later
-        data_to_init.body_data_[i].body_num  = i;
-
-        InitScalar(userH5File, bodyName + "/properties/disp_vol", data_to_init.body_data_[i].disp_vol);
-        Init1D(userH5File, bodyName + "/hydro_coeffs/radiation_damping/impulse_response_fun/t",
-               data_to_init.body_data_[i].rirf_time_vector);
-
-        // do not need rirf_timestep?
-        data_to_init.body_data_[i].rirf_timestep =
-            data_to_init.body_data_[i].rirf_time_vector[1] - data_to_init.body_data_[i].rirf_time_vector[0];
-
-        Init1D(userH5File, bodyName + "/properties/cg", data_to_init.body_data_[i].cg);
-        Init1D(userH5File, bodyName + "/properties/cb", data_to_init.body_data_[i].cb);
-        Init2D(userH5File, bodyName + "/hydro_coeffs/linear_restoring_stiffness",
-               data_to_init.body_data_[i].lin_matrix);
-        Init2D(userH5File, bodyName + "/hydro_coeffs/added_mass/inf_freq", data_to_init.body_data_[i].inf_added_mass);
-        data_to_init.body_data_[i].inf_added_mass *= rho;
-        Init3D(userH5File, bodyName + "/hydro_coeffs/radiation_damping/impulse_response_fun/K",
-               data_to_init.body_data_[i].rirf_matrix);
-        // Init3D(userH5File, bodyName + "/hydro_coeffs/radiation_damping/all",
-        //       data_to_init.body_data[i].radiation_damping_matrix);
-
-        // reg wave
-        Init1D(userH5File, "simulation_parameters/w", data_to_init.reg_wave_data_[i].freq_list);
-        Init3D(userH5File, bodyName + "/hydro_coeffs/excitation/mag",
-               data_to_init.reg_wave_data_[i].excitation_mag_matrix);
-
-        // scale by rho * g
-        data_to_init.reg_wave_data_[i].excitation_mag_matrix =
-            data_to_init.reg_wave_data_[i].excitation_mag_matrix *
-            data_to_init.reg_wave_data_[i].excitation_mag_matrix.constant(rho * g);
-        Init3D(userH5File, bodyName + "/hydro_coeffs/excitation/phase",
-               data_to_init.reg_wave_data_[i]
-                   .excitation_phase_matrix);  // TODO does this also need to be scaled by rho * g?
-
-        // irreg wave
-        // Init3D(userH5File, bodyName + "/hydro_coeffs/excitation/re", excitation_re_matrix, re_dims);
-        // Init3D(userH5File, bodyName + "/hydro_coeffs/excitation/im", excitation_im_matrix, im_dims);
-        Init1D(userH5File, bodyName + "/hydro_coeffs/excitation/impulse_response_fun/t",
-               data_to_init.irreg_wave_data_[i].excitation_irf_time);
-        // TODO change this to a temp tensor and manip it into a 2d matrix for ecitation_irf_matrix?
-        // TODO look up Eigen resize and map to make this temp conversion better
-        Eigen::Tensor<double, 3> temp;
-        Init3D(userH5File, bodyName + "/hydro_coeffs/excitation/impulse_response_fun/f", temp);
-        data_to_init.irreg_wave_data_[i].excitation_irf_matrix = SqueezeMid(temp);
-        data_to_init.irreg_wave_data_[i].excitation_irf_matrix *= rho * g;
-    }
+    data_to_init.sim_data_.h5_file_name = h5_file_name_;
+    InitScalar(*userH5File, "simulation_parameters/rho", data_to_init.sim_data_.rho);
+    InitScalar(*userH5File, "simulation_parameters/g", data_to_init.sim_data_.g);
+    InitScalar(*userH5File, "simulation_parameters/water_depth", data_to_init.sim_data_.water_depth);
+
+    // for each body things, bodies read concurrently
+    ForEachBody(num_bodies_, num_threads_, [&](int b) { InitBodyData(*userH5File, data_to_init, b); });
+
+    // excitation data, only for the waves that need it
+    InitOptionalData(*userH5File, data_to_init, requirements);
 
-    userH5File.close();
     // WriteDataToFile(excitation_irf_dims, "excitation_irf_dims.txt");
     // WriteDataToFile(excitation_irf_matrix, "excitation_irf_matrix.txt");
     return data_to_init;
 }
 
-// squeezes the middle dimension of 1 out
-Eigen::MatrixXd H5FileInfo::SqueezeMid(Eigen::Tensor<double, 3>& to_be_squeezed) {
-    assert(to_be_squeezed.dimension(1));
-    int dof  = to_be_squeezed.dimension(0);
-    int size = to_be_squeezed.dimension(2);
-    Eigen::MatrixXd squozen(dof, size);
-    for (int i = 0; i < dof; i++) {
-        for (int j = 0; j < size; j++) {
-            // squeeze 6x1x1000 or whatever into 6x1000 matrix
-            squozen(i, j) = to_be_squeezed(i, 0, j);
-        }
+void H5FileInfo::ReadOptionalData(HydroData& data, const HydroDataRequirements& requirements) {
+    if (static_cast<int>(data.body_data_.size()) != num_bodies_) {
+        throw std::invalid_argument("H5FileInfo: HydroData does not have the bodies of " + h5_file_name_ + ".");
+    }
+    timings_.clear();
+    auto userH5File = OpenH5File(h5_file_name_);
+    InitOptionalData(*userH5File, data, requirements);
+}
+
+void H5FileInfo::SetNumThreads(int num_threads) {
+    if (num_threads < 0) {
+        throw std::invalid_argument("H5FileInfo: invalid number of threads " + std::to_string(num_threads) + ".");
+    }
+#ifdef _OPENMP
+    num_threads_ = num_threads == 0 ? omp_get_max_threads() : num_threads;
+#else
+    num_threads_ = 1;
+#endif
+}
+
+void H5FileInfo::InitBodyData(H5::H5File& file, HydroData& data, int b) {
+    const double rho = data.sim_data_.rho;
+    auto& body       = data.body_data_[b];
+    body.body_name   = "body" + std::to_string(b + 1);
+    body.body_num    = b;
+
+    const std::string& bodyName = body.body_name;  // shortcut for reading later
+
+    InitScalar(file, bodyName + "/properties/disp_vol", body.disp_vol);
+    Init1D(file, bodyName + "/hydro_coeffs/radiation_damping/impulse_response_fun/t", body.rirf_time_vector);
+
+    // do not need rirf_timestep?
+    body.rirf_timestep = body.rirf_time_vector[1] - body.rirf_time_vector[0];
+
+    Init1D(file, bodyName + "/properties/cg", body.cg);
+    Init1D(file, bodyName + "/properties/cb", body.cb);
+    Init2D(file, bodyName + "/hydro_coeffs/linear_restoring_stiffness", body.lin_matrix);
+    Init2D(file, bodyName + "/hydro_coeffs/added_mass/inf_freq", body.inf_added_mass, rho);
+    Init3D(file, bodyName + "/hydro_coeffs/radiation_damping/impulse_response_fun/K", body.rirf_matrix);
+    body.rirf_state_space = InitRadiationStateSpace(file, bodyName, rho);
+    // Init3D(userH5File, bodyName + "/hydro_coeffs/radiation_damping/all",
+    //       data_to_init.body_data[i].radiation_damping_matrix);
+}
+
+void H5FileInfo::InitOptionalData(H5::H5File& file, HydroData& data, const HydroDataRequirements& requirements) {
+    if (!requirements.regular_excitation && !requirements.irregular_excitation && !requirements.excitation_irf) {
+        return;
+    }
+
+    // wave frequencies, the same for every body
+    Eigen::VectorXd freq_list;
+    if (requirements.regular_excitation || requirements.irregular_excitation) {
+        Init1D(file, "simulation_parameters/w", freq_list);
+    }
+
+    // bodies read concurrently
+    ForEachBody(num_bodies_, num_threads_,
+                [&](int b) { InitOptionalBodyData(file, data, requirements, freq_list, b); });
+
+    data.loaded_ = data.loaded_ | requirements;
+}
+
+void H5FileInfo::InitOptionalBodyData(H5::H5File& file,
+                                      HydroData& data,
+                                      const HydroDataRequirements& requirements,
+                                      const Eigen::VectorXd& freq_list,
+                                      int b) {
+    const double rho           = data.sim_data_.rho;
+    const double g             = data.sim_data_.g;
+    const std::string bodyName = "body" + std::to_string(b + 1);
+
+    // reg wave, magnitude scaled by rho * g
+    if (requirements.regular_excitation) {
+        data.reg_wave_data_[b].freq_list = freq_list;
+        Init3D(file, bodyName + "/hydro_coeffs/excitation/mag", data.reg_wave_data_[b].excitation_mag_matrix, rho * g);
+        // TODO does the phase also need to be scaled by rho * g?
+        Init3D(file, bodyName + "/hydro_coeffs/excitation/phase", data.reg_wave_data_[b].excitation_phase_matrix);
+    }
+
+    // irreg wave, excitation coefficients scaled by rho * g like the magnitude
+    if (requirements.irregular_excitation) {
+        data.irreg_wave_data_[b].freq_list = freq_list;
+        InitSqueezeMid(file, bodyName + "/hydro_coeffs/excitation/re", data.irreg_wave_data_[b].excitation_re_matrix,
+                       rho * g);
+        InitSqueezeMid(file, bodyName + "/hydro_coeffs/excitation/im", data.irreg_wave_data_[b].excitation_im_matrix,
+                       rho * g);
+    }
+    if (requirements.excitation_irf) {
+        Init1D(file, bodyName + "/hydro_coeffs/excitation/impulse_response_fun/t",
+               data.irreg_wave_data_[b].excitation_irf_time);
+        InitSqueezeMid(file, bodyName + "/hydro_coeffs/excitation/impulse_response_fun/f",
+                       data.irreg_wave_data_[b].excitation_irf_matrix, rho * g);
     }
-    return squozen;
 }
 
 void H5FileInfo::InitScalar(H5::H5File& file, std::string data_name, double& var) {
+    DatasetRead read(data_name);
     H5::DataSet dataset   = file.openDataSet(data_name);
     H5::DataType datatype = dataset.getDataType();
 
@@ -138,90 +343,127 @@ void H5FileInfo::InitScalar(H5::H5File& file, std::string data_name, double& var
     }
 
     dataset.close();
+    read.Finish(1, timings_);
 }
 
-void H5FileInfo::Init1D(H5::H5File& file, std::string data_name, Eigen::VectorXd& var) {
-    // open specific dataset
-    H5::DataSet dataset = file.openDataSet(data_name);
-    // Get filespace for rank and dimension
+void H5FileInfo::Init1D(H5::H5File& file, std::string data_name, Eigen::VectorXd& var, double scale) {
+    DatasetRead read(data_name);
+    H5::DataSet dataset     = file.openDataSet(data_name);
     H5::DataSpace filespace = dataset.getSpace();
-    // Get number of dimensions in the file dataspace
-    // Get and print the dimension sizes of the file dataspace
-    hsize_t dims[2] = {0, 0};  // dataset dimensions
-    int rank        = filespace.getSimpleExtentDims(dims);
-    // read file into data_out 2d array
-    H5::DataSpace mspace1(rank, dims);
-    double* temp = new double[dims[0] * dims[1]];
-    // read file info into current_pos
-    dataset.read(temp, H5::PredType::NATIVE_DOUBLE, mspace1, filespace);
-    var.resize(dims[0] * dims[1]);
-    for (int i = 0; i < dims[0] * dims[1]; i++) {
-        var[i] = temp[i];
+    var.resize(filespace.getSimpleExtentNpoints());
+    // same layout in the file and in memory, read in place
+    dataset.read(var.data(), H5::PredType::NATIVE_DOUBLE, filespace, filespace);
+    if (scale != 1.0) {
+        read.Release();
+        var *= scale;
+        read.Acquire();
     }
     dataset.close();
-    delete[] temp;
+    read.Finish(var.size(), timings_);
 }
 
-void H5FileInfo::Init2D(H5::H5File& file, std::string data_name, Eigen::MatrixXd& var) {
-    // data_name = bodyName + "/hydro_coeffs/radiation_damping/impulse_response_fun/K";
+void H5FileInfo::Init2D(H5::H5File& file, std::string data_name, Eigen::MatrixXd& var, double scale) {
+    DatasetRead read(data_name);
     H5::DataSet dataset     = file.openDataSet(data_name);
     H5::DataSpace filespace = dataset.getSpace();
     hsize_t dims[2]         = {0, 0};
     int rank                = filespace.getSimpleExtentDims(dims);
-    // read file into data_out 2d array
-    H5::DataSpace mspace(rank, dims);
-    // rirf_dims[0] is number of rows, rirf_dims[1] is number of columns, rirf_dims[2] is number of matrices
-    double* temp = new double[dims[0] * dims[1]];
-    // read file info into data_out, a 2d array
-    dataset.read(temp, H5::PredType::NATIVE_DOUBLE, mspace, filespace);
-    // set var here
     var.resize(dims[0], dims[1]);
-    for (int i = 0; i < dims[0]; i++) {
-        for (int j = 0; j < dims[1]; j++) {
-            var(i, j) = temp[i * dims[1] + j];
-        }
-    }
+    ReadColumnMajor(dataset, filespace, rank, dims, var.data(), scale, read);
     dataset.close();
-    delete[] temp;
+    read.Finish(var.size(), timings_);
 }
 
-void H5FileInfo::Init3D(H5::H5File& file, std::string data_name, Eigen::Tensor<double, 3>& var) {
-    // open specific dataset
-    H5::DataSet dataset = file.openDataSet(data_name);
-    // Get filespace for rank and dimension
+void H5FileInfo::Init3D(H5::H5File& file, std::string data_name, Eigen::Tensor<double, 3>& var, double scale) {
+    DatasetRead read(data_name);
+    H5::DataSet dataset     = file.openDataSet(data_name);
     H5::DataSpace filespace = dataset.getSpace();
     hsize_t dims[3]         = {0, 0, 0};
     int rank                = filespace.getSimpleExtentDims(dims);
-    // read file into data_out 2d array
-    H5::DataSpace mspace(rank, dims);
-    // rirf_dims[0] is number of rows, rirf_dims[1] is number of columns, rirf_dims[2] is number of matrices
-    double* temp = new double[dims[0] * dims[1] * dims[2]];
-    // read file info into data_out, a 2d array
-    dataset.read(temp, H5::PredType::NATIVE_DOUBLE, mspace, filespace);
-    // set var here
     var.resize((int64_t)dims[0], (int64_t)dims[1], (int64_t)dims[2]);
-    for (int i = 0; i < dims[0]; i++) {
-        for (int j = 0; j < dims[1]; j++) {
-            for (int k = 0; k < dims[2]; k++) {
-                int index    = k + dims[2] * (j + i * dims[1]);
-                var(i, j, k) = temp[index];
-            }
-        }
+    ReadColumnMajor(dataset, filespace, rank, dims, var.data(), scale, read);
+    dataset.close();
+    read.Finish(var.size(), timings_);
+}
+
+void H5FileInfo::Init4D(H5::H5File& file, std::string data_name, Eigen::Tensor<double, 4>& var, double scale) {
+    DatasetRead read(data_name);
+    H5::DataSet dataset     = file.openDataSet(data_name);
+    H5::DataSpace filespace = dataset.getSpace();
+    hsize_t dims[4]         = {0, 0, 0, 0};
+    int rank                = filespace.getSimpleExtentDims(dims);
+    var.resize((int64_t)dims[0], (int64_t)dims[1], (int64_t)dims[2], (int64_t)dims[3]);
+    ReadColumnMajor(dataset, filespace, rank, dims, var.data(), scale, read);
+    dataset.close();
+    read.Finish(var.size(), timings_);
+}
+
+void H5FileInfo::InitSqueezeMid(H5::H5File& file, std::string data_name, Eigen::MatrixXd& var, double scale) {
+    DatasetRead read(data_name);
+    H5::DataSet dataset     = file.openDataSet(data_name);
+    H5::DataSpace filespace = dataset.getSpace();
+    hsize_t dims[3]         = {0, 0, 0};
+    int rank                = filespace.getSimpleExtentDims(dims);
+    if (rank != 3 || dims[1] == 0) {
+        throw std::runtime_error("H5FileInfo: " + data_name + " is not a 3D dataset.");
     }
+    // only the first index of the middle dimension: the rows [i, 0, :] of the file are the rows of var
+    var.resize(dims[0], dims[2]);
+    Eigen::VectorXd buffer;
+    const hsize_t start[3] = {0, 0, 0};
+    const hsize_t count[3] = {dims[0], 1, dims[2]};
+    ReadHyperslab(dataset, filespace, start, count, buffer);
+    read.Release();
+    var = scale * Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(
+                      buffer.data(), dims[0], dims[2]);
+    read.Acquire();
     dataset.close();
-    delete[] temp;
+    read.Finish(var.size(), timings_);
+}
+
+std::optional<HydroData::RadiationStateSpaceInfo> H5FileInfo::InitRadiationStateSpace(H5::H5File& file,
+                                                                                       const std::string& body_name,
+                                                                                       double rho) {
+    const std::string ss_name = body_name + "/hydro_coeffs/radiation_damping/state_space";
+    {
+        std::lock_guard<std::mutex> lock(GetH5Mutex());
+        if (!file.nameExists(ss_name) || !file.nameExists(ss_name + "/A") || !file.nameExists(ss_name + "/it")) {
+            return std::nullopt;
+        }
+    }
+
+    HydroData::RadiationStateSpaceInfo ss;
+    Init4D(file, ss_name + "/A/all", ss.A);
+    Init4D(file, ss_name + "/B/all", ss.B);
+    Init4D(file, ss_name + "/C/all", ss.C, rho);  // scaled by rho, like the RIRF
+    Init2D(file, ss_name + "/D/all", ss.D, rho);
+    Eigen::MatrixXd order;
+    Init2D(file, ss_name + "/it", order);
+    ss.order = order.cast<int>();
+
+    return ss;
 }
 
 H5FileInfo::~H5FileInfo() {}
 
 // TODO check order of function definitions here matches order in .h file
+void HydroData::Require(const HydroDataRequirements& requirements) {
+    const HydroDataRequirements missing = {requirements.regular_excitation && !loaded_.regular_excitation,
+                                           requirements.irregular_excitation && !loaded_.irregular_excitation,
+                                           requirements.excitation_irf && !loaded_.excitation_irf};
+    if (!missing.regular_excitation && !missing.irregular_excitation && !missing.excitation_irf) {
+        return;
+    }
+    H5FileInfo(sim_data_.h5_file_name, static_cast<int>(body_data_.size())).ReadOptionalData(*this, missing);
+}
+
 void HydroData::resize(int num_bodies) {
     body_data_.resize(num_bodies);
     reg_wave_data_.resize(num_bodies);
     irreg_wave_data_.resize(num_bodies);
 }
 
-Eigen::MatrixXd HydroData::GetInfAddedMassMatrix(int b) const {
+const Eigen::MatrixXd& HydroData::GetInfAddedMassMatrix(int b) const {
     return body_data_[b].inf_added_mass;
 }
 
@@ -229,16 +471,39 @@ double HydroData::GetHydrostaticStiffnessVal(int b, int i, int j) const {
     return body_data_[b].lin_matrix(i, j) * sim_data_.rho * sim_data_.g;
 }
 
-Eigen::MatrixXd HydroData::GetLinMatrix(int b) const {
+const Eigen::MatrixXd& HydroData::GetLinMatrix(int b) const {
     return body_data_[b].lin_matrix;
 }
 
 double HydroData::GetRIRFVal(int b, int dof, int col, int s) const {
-    return body_data_[b].rirf_matrix(dof, col, s) * sim_data_.rho;  // scale radiation force by rho
+    const auto& body = body_data_[b];
+    if (body.rirf_mapped != nullptr) {
+        const auto& dims = body.rirf_mapped_dims;
+        return body.rirf_mapped[dof + dims[0] * (col + dims[1] * s)] * sim_data_.rho;
+    }
+    return body.rirf_matrix(dof, col, s) * sim_data_.rho;  // scale radiation force by rho
+}
+
+bool HydroData::HasRadiationStateSpace() const {
+    for (const auto& body : body_data_) {
+        if (!body.rirf_state_space.has_value()) {
+            return false;
+        }
+    }
+    return !body_data_.empty();
+}
+
+const HydroData::RadiationStateSpaceInfo& HydroData::GetRadiationStateSpace(int b) const {
+    if (!body_data_[b].rirf_state_space.has_value()) {
+        throw std::runtime_error("No state space realization of the RIRF in the h5 file for body " +
+                                 std::to_string(b + 1) + ".");
+    }
+    return *body_data_[b].rirf_state_space;
 }
 
 int HydroData::GetRIRFDims(int i) const {
-    return body_data_[0].rirf_matrix.dimension(i);
+    const auto& body = body_data_[0];
+    return static_cast<int>(body.rirf_mapped != nullptr ? body.rirf_mapped_dims[i] : body.rirf_matrix.dimension(i));
 }
 
 Eigen::VectorXd HydroData::GetRIRFTimeVector() const {
@@ -0,0 +1,99 @@
+/*********************************************************************
+ * @file  harmonic_synthesis.cpp
+ *
+ * @brief implementation file for HarmonicSynthesis.
+ *********************************************************************/
+#include <hydroc/harmonic_synthesis.h>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <string>
+
+HarmonicSynthesis::HarmonicSynthesis(int num_frequencies, double omega_0, double d_omega, double dt)
+    : num_frequencies_(num_frequencies), omega_0_(omega_0), d_omega_(d_omega), dt_(dt) {
+    if (num_frequencies_ < 1 || dt_ <= 0.0) {
+        throw std::invalid_argument("HarmonicSynthesis: requires at least one frequency and a positive time step.");
+    }
+
+    // FFT size for a linear convolution of K coefficients with blocks of at least K samples
+    fft_size_ = 1;
+    while (fft_size_ < 2 * num_frequencies_) {
+        fft_size_ *= 2;
+    }
+    block_size_ = fft_size_ - num_frequencies_ + 1;
+
+    // W^(j^2 / 2) = exp(i theta j^2 / 2), theta = d_omega dt
+    const double theta = d_omega_ * dt_;
+    const int max_j    = std::max(num_frequencies_, block_size_);
+    chirp_.resize(max_j);
+    for (int j = 0; j < max_j; j++) {
+        chirp_[j] = std::polar(1.0, 0.5 * theta * static_cast<double>(j) * j);
+    }
+
+    // W^(-j^2 / 2) for the lags j = n - k, negative lags wrapped around
+    Eigen::VectorXcd kernel = Eigen::VectorXcd::Zero(fft_size_);
+    for (int j = 0; j < block_size_; j++) {
+        kernel[j] = std::conj(chirp_[j]);
+    }
+    for (int j = 1; j < num_frequencies_; j++) {
+        kernel[fft_size_ - j] = std::conj(chirp_[j]);
+    }
+    Eigen::FFT<double> fft;
+    fft.fwd(chirp_spectrum_, kernel);
+}
+
+Eigen::MatrixXd HarmonicSynthesis::Synthesize(const Eigen::Ref<const Eigen::MatrixXcd>& coefficients,
+                                              double t_0,
+                                              int num_samples) const {
+    if (coefficients.rows() != num_frequencies_ || num_samples < 0) {
+        throw std::invalid_argument("HarmonicSynthesis: expected " + std::to_string(num_frequencies_) +
+                                    " coefficients per series.");
+    }
+
+    // local FFT plan and buffers, so that concurrent calls do not share state
+    Eigen::FFT<double> fft;
+    Eigen::VectorXcd work(fft_size_);
+    Eigen::VectorXcd work_spectrum(fft_size_);
+
+    Eigen::MatrixXd series(num_samples, coefficients.cols());
+    for (int first = 0; first < num_samples; first += block_size_) {
+        const int count  = std::min(block_size_, num_samples - first);
+        const double t_b = t_0 + first * dt_;
+        for (int c = 0; c < coefficients.cols(); c++) {
+            // a_k = c_k exp(i k d_omega t_b), u_k = a_k W^(k^2 / 2)
+            work.setZero();
+            for (int k = 0; k < num_frequencies_; k++) {
+                work[k] = coefficients(k, c) * std::polar(1.0, k * d_omega_ * t_b) * chirp_[k];
+            }
+            fft.fwd(work_spectrum, work);
+            work_spectrum = work_spectrum.cwiseProduct(chirp_spectrum_);
+            fft.inv(work, work_spectrum);
+
+            // y_n = W^(n^2 / 2) (u * v)_n, then the carrier of the first frequency
+            for (int n = 0; n < count; n++) {
+                const std::complex<double> carrier = std::polar(1.0, omega_0_ * (t_b + n * dt_));
+                series(first + n, c)               = (carrier * chirp_[n] * work[n]).real();
+            }
+        }
+    }
+    return series;
+}
+
+bool IsUniformlySpaced(const Eigen::Ref<const Eigen::VectorXd>& values, double tolerance) {
+    const int last = static_cast<int>(values.size()) - 1;
+    if (last < 1) {
+        return false;
+    }
+    const double spacing = (values[last] - values[0]) / last;
+    if (spacing == 0.0) {
+        return false;
+    }
+    for (int i = 1; i < last; i++) {
+        if (std::abs(values[i] - (values[0] + i * spacing)) > tolerance * std::abs(spacing)) {
+            return false;
+        }
+    }
+    return true;
+}
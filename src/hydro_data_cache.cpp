@@ -0,0 +1,85 @@
+/*********************************************************************
+ * @file  hydro_data_cache.cpp
+ *
+ * @brief implementation file for HydroDataCache.
+ *********************************************************************/
+#include <hydroc/hydro_data_cache.h>
+#include <hydroc/hydro_database.h>
+
+#include <filesystem>  // C++17
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace {
+struct CacheEntry {
+    std::filesystem::file_time_type modification_time;
+    std::shared_ptr<const HydroData> data;
+};
+
+// entries by absolute file path and number of bodies
+std::map<std::pair<std::string, int>, CacheEntry>& GetEntries() {
+    static std::map<std::pair<std::string, int>, CacheEntry> entries;
+    return entries;
+}
+
+std::mutex& GetMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+bool Covers(const HydroDataRequirements& loaded, const HydroDataRequirements& requirements) {
+    return (loaded.regular_excitation || !requirements.regular_excitation) &&
+           (loaded.irregular_excitation || !requirements.irregular_excitation) &&
+           (loaded.excitation_irf || !requirements.excitation_irf);
+}
+}  // namespace
+
+std::shared_ptr<const HydroData> HydroDataCache::Get(const std::string& file_name,
+                                                     int num_bodies,
+                                                     const HydroDataRequirements& requirements) {
+    const std::string path       = std::filesystem::absolute(file_name).lexically_normal().generic_string();
+    const auto modification_time = std::filesystem::last_write_time(path);
+
+    std::lock_guard<std::mutex> lock(GetMutex());
+    auto& entry = GetEntries()[{path, num_bodies}];
+    if (entry.data != nullptr && entry.modification_time == modification_time &&
+        Covers(entry.data->GetLoadedRequirements(), requirements)) {
+        return entry.data;
+    }
+
+    // groups of the stale entry kept, unless the file changed
+    HydroDataRequirements groups = requirements;
+    if (entry.data != nullptr && entry.modification_time == modification_time) {
+        groups = groups | entry.data->GetLoadedRequirements();
+    }
+    try {
+        entry.data = std::make_shared<const HydroData>(Load(path, num_bodies, groups));
+    } catch (...) {
+        GetEntries().erase({path, num_bodies});
+        throw;
+    }
+    entry.modification_time = modification_time;
+    return entry.data;
+}
+
+HydroData HydroDataCache::Load(const std::string& file_name,
+                               int num_bodies,
+                               const HydroDataRequirements& requirements) {
+    if (HydroDatabase::IsDatabase(file_name)) {
+        HydroData data = HydroDatabase::Read(file_name, num_bodies);
+        data.Require(requirements);
+        return data;
+    }
+    return H5FileInfo(file_name, num_bodies).ReadH5Data(requirements);
+}
+
+void HydroDataCache::Clear() {
+    std::lock_guard<std::mutex> lock(GetMutex());
+    GetEntries().clear();
+}
+
+std::size_t HydroDataCache::GetSize() {
+    std::lock_guard<std::mutex> lock(GetMutex());
+    return GetEntries().size();
+}
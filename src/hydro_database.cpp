@@ -0,0 +1,310 @@
+/*********************************************************************
+ * @file  hydro_database.cpp
+ *
+ * @brief implementation file for HydroDatabase.
+ *********************************************************************/
+#include <hydroc/hydro_database.h>
+#include <hydroc/mapped_file.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <stdexcept>
+
+namespace {
+// binary layout, native byte order, every field 8 bytes aligned: magic, format version, number of bodies, rho, g,
+// water depth, loaded optional groups (bit 0 regular excitation, bit 1 irregular excitation, bit 2 excitation IRF),
+// h5 file name, then for each body its BodyInfo, then the loaded optional groups of each body. Strings are a length
+// followed by the characters padded to 8 bytes, arrays a rank and dimensions followed by the column-major values.
+constexpr char kDatabaseMagic[8]         = {'H', 'C', 'H', 'Y', 'D', 'R', 'D', 'B'};
+constexpr std::uint64_t kDatabaseVersion = 1;
+
+class DatabaseWriter {
+  public:
+    explicit DatabaseWriter(const std::string& file_name)
+        : file_name_(file_name), file_(file_name, std::ios::binary) {}
+
+    void WriteMagic() { file_.write(kDatabaseMagic, sizeof(kDatabaseMagic)); }
+
+    void WriteCount(std::uint64_t value) { file_.write(reinterpret_cast<const char*>(&value), sizeof(value)); }
+
+    void WriteDouble(double value) { file_.write(reinterpret_cast<const char*>(&value), sizeof(value)); }
+
+    void WriteString(const std::string& value) {
+        static const char padding[8] = {};
+        WriteCount(value.size());
+        file_.write(value.data(), value.size());
+        file_.write(padding, (8 - value.size() % 8) % 8);
+    }
+
+    void WriteArray(const double* values, std::initializer_list<Eigen::Index> dims) {
+        std::uint64_t size = 1;
+        WriteCount(dims.size());
+        for (const auto dim : dims) {
+            WriteCount(dim);
+            size *= dim;
+        }
+        file_.write(reinterpret_cast<const char*>(values), sizeof(double) * size);
+    }
+
+    void WriteVector(const Eigen::VectorXd& value) { WriteArray(value.data(), {value.size()}); }
+
+    void WriteMatrix(const Eigen::MatrixXd& value) { WriteArray(value.data(), {value.rows(), value.cols()}); }
+
+    template <int Rank>
+    void WriteTensor(const Eigen::Tensor<double, Rank>& value) {
+        if constexpr (Rank == 3) {
+            WriteArray(value.data(), {value.dimension(0), value.dimension(1), value.dimension(2)});
+        } else {
+            WriteArray(value.data(), {value.dimension(0), value.dimension(1), value.dimension(2), value.dimension(3)});
+        }
+    }
+
+    void Close() {
+        file_.close();
+        if (!file_) {
+            throw std::runtime_error("Unable to write hydro database " + file_name_ + ".");
+        }
+    }
+
+  private:
+    std::string file_name_;
+    std::ofstream file_;
+};
+
+// reads the fields in order from the mapped file, throws if they run past its end
+class DatabaseReader {
+  public:
+    DatabaseReader(const MappedFile& file, const std::string& file_name)
+        : data_(file.GetData()), size_(file.GetSize()), file_name_(file_name) {}
+
+    bool ReadMagic() {
+        return std::memcmp(Advance(sizeof(kDatabaseMagic)), kDatabaseMagic, sizeof(kDatabaseMagic)) == 0;
+    }
+
+    std::uint64_t ReadCount() {
+        std::uint64_t value;
+        std::memcpy(&value, Advance(sizeof(value)), sizeof(value));
+        return value;
+    }
+
+    double ReadDouble() {
+        double value;
+        std::memcpy(&value, Advance(sizeof(value)), sizeof(value));
+        return value;
+    }
+
+    std::string ReadString() {
+        const std::uint64_t length = ReadCount();
+        if (length > size_) {
+            Fail();
+        }
+        std::string value(Advance(length), length);
+        Advance((8 - length % 8) % 8);
+        return value;
+    }
+
+    // values used in place, the mapping is 8 bytes aligned as every field before them
+    const double* ReadArray(int rank, Eigen::Index* dims) {
+        if (ReadCount() != static_cast<std::uint64_t>(rank)) {
+            Fail();
+        }
+        std::uint64_t size = 1;
+        for (int d = 0; d < rank; d++) {
+            const std::uint64_t dim = ReadCount();
+            if (dim > size_ || (dim > 0 && size > size_ / dim)) {
+                Fail();
+            }
+            dims[d] = static_cast<Eigen::Index>(dim);
+            size *= dim;
+        }
+        if (size > size_ / sizeof(double)) {
+            Fail();
+        }
+        return reinterpret_cast<const double*>(Advance(sizeof(double) * size));
+    }
+
+    void ReadVector(Eigen::VectorXd& value) {
+        Eigen::Index dims[1];
+        const double* values = ReadArray(1, dims);
+        value                = Eigen::Map<const Eigen::VectorXd>(values, dims[0]);
+    }
+
+    void ReadMatrix(Eigen::MatrixXd& value) {
+        Eigen::Index dims[2];
+        const double* values = ReadArray(2, dims);
+        value                = Eigen::Map<const Eigen::MatrixXd>(values, dims[0], dims[1]);
+    }
+
+    template <int Rank>
+    void ReadTensor(Eigen::Tensor<double, Rank>& value) {
+        Eigen::array<Eigen::Index, Rank> dims;
+        const double* values = ReadArray(Rank, dims.data());
+        value                = Eigen::TensorMap<const Eigen::Tensor<double, Rank>>(values, dims);
+    }
+
+    bool AtEnd() const { return offset_ == size_; }
+
+    [[noreturn]] void Fail() const { throw std::runtime_error("Invalid hydro database " + file_name_ + "."); }
+
+  private:
+    const char* data_;
+    std::size_t size_;
+    std::size_t offset_ = 0;
+    std::string file_name_;
+
+    const char* Advance(std::size_t size) {
+        if (size > size_ - offset_) {
+            Fail();
+        }
+        const char* field = data_ + offset_;
+        offset_ += size;
+        return field;
+    }
+};
+
+std::uint64_t GetGroupBits(const HydroDataRequirements& groups) {
+    return (groups.regular_excitation ? 1 : 0) | (groups.irregular_excitation ? 2 : 0) |
+           (groups.excitation_irf ? 4 : 0);
+}
+}  // namespace
+
+void HydroDatabase::Write(const std::string& file_name, const HydroData& data) {
+    const auto& loaded = data.loaded_;
+    DatabaseWriter writer(file_name);
+    writer.WriteMagic();
+    writer.WriteCount(kDatabaseVersion);
+    writer.WriteCount(data.body_data_.size());
+    writer.WriteDouble(data.sim_data_.rho);
+    writer.WriteDouble(data.sim_data_.g);
+    writer.WriteDouble(data.sim_data_.water_depth);
+    writer.WriteCount(GetGroupBits(loaded));
+    writer.WriteString(data.sim_data_.h5_file_name);
+
+    for (const auto& body : data.body_data_) {
+        writer.WriteString(body.body_name);
+        writer.WriteDouble(body.disp_vol);
+        writer.WriteVector(body.rirf_time_vector);
+        writer.WriteDouble(body.rirf_timestep);
+        writer.WriteVector(body.cg);
+        writer.WriteVector(body.cb);
+        writer.WriteMatrix(body.lin_matrix);
+        writer.WriteMatrix(body.inf_added_mass);
+        if (body.rirf_mapped != nullptr) {
+            const auto& dims = body.rirf_mapped_dims;
+            writer.WriteArray(body.rirf_mapped, {dims[0], dims[1], dims[2]});
+        } else {
+            writer.WriteTensor(body.rirf_matrix);
+        }
+        writer.WriteCount(body.rirf_state_space.has_value() ? 1 : 0);
+        if (body.rirf_state_space.has_value()) {
+            const auto& ss = *body.rirf_state_space;
+            writer.WriteTensor(ss.A);
+            writer.WriteTensor(ss.B);
+            writer.WriteTensor(ss.C);
+            writer.WriteMatrix(ss.D);
+            writer.WriteMatrix(ss.order.cast<double>());
+        }
+    }
+
+    for (size_t b = 0; b < data.body_data_.size(); b++) {
+        if (loaded.regular_excitation) {
+            const auto& reg = data.reg_wave_data_[b];
+            writer.WriteVector(reg.freq_list);
+            writer.WriteTensor(reg.excitation_mag_matrix);
+            writer.WriteTensor(reg.excitation_phase_matrix);
+        }
+        const auto& irreg = data.irreg_wave_data_[b];
+        if (loaded.irregular_excitation) {
+            writer.WriteVector(irreg.freq_list);
+            writer.WriteMatrix(irreg.excitation_re_matrix);
+            writer.WriteMatrix(irreg.excitation_im_matrix);
+        }
+        if (loaded.excitation_irf) {
+            writer.WriteVector(irreg.excitation_irf_time);
+            writer.WriteMatrix(irreg.excitation_irf_matrix);
+        }
+    }
+    writer.Close();
+}
+
+HydroData HydroDatabase::Read(const std::string& file_name, int num_bodies) {
+    auto file = MappedFile::Open(file_name);
+    DatabaseReader reader(*file, file_name);
+    if (!reader.ReadMagic() || reader.ReadCount() != kDatabaseVersion) {
+        reader.Fail();
+    }
+    const std::uint64_t stored_bodies = reader.ReadCount();
+    if (stored_bodies != static_cast<std::uint64_t>(num_bodies)) {
+        throw std::invalid_argument("Hydro database " + file_name + " has " + std::to_string(stored_bodies) +
+                                    " bodies, expected " + std::to_string(num_bodies) + ".");
+    }
+
+    HydroData data;
+    data.resize(num_bodies);
+    data.mapped_file_           = file;
+    data.sim_data_.rho          = reader.ReadDouble();
+    data.sim_data_.g            = reader.ReadDouble();
+    data.sim_data_.water_depth  = reader.ReadDouble();
+    const std::uint64_t groups  = reader.ReadCount();
+    data.sim_data_.h5_file_name = reader.ReadString();
+    data.loaded_                = {(groups & 1) != 0, (groups & 2) != 0, (groups & 4) != 0};
+    if (groups != GetGroupBits(data.loaded_)) {
+        reader.Fail();
+    }
+
+    for (int b = 0; b < num_bodies; b++) {
+        auto& body     = data.body_data_[b];
+        body.body_name = reader.ReadString();
+        body.body_num  = b;
+        body.disp_vol  = reader.ReadDouble();
+        reader.ReadVector(body.rirf_time_vector);
+        body.rirf_timestep = reader.ReadDouble();
+        reader.ReadVector(body.cg);
+        reader.ReadVector(body.cb);
+        reader.ReadMatrix(body.lin_matrix);
+        reader.ReadMatrix(body.inf_added_mass);
+        body.rirf_mapped = reader.ReadArray(3, body.rirf_mapped_dims.data());
+        if (reader.ReadCount() != 0) {
+            HydroData::RadiationStateSpaceInfo ss;
+            Eigen::MatrixXd order;
+            reader.ReadTensor(ss.A);
+            reader.ReadTensor(ss.B);
+            reader.ReadTensor(ss.C);
+            reader.ReadMatrix(ss.D);
+            reader.ReadMatrix(order);
+            ss.order              = order.cast<int>();
+            body.rirf_state_space = std::move(ss);
+        }
+    }
+
+    for (int b = 0; b < num_bodies; b++) {
+        if (data.loaded_.regular_excitation) {
+            auto& reg = data.reg_wave_data_[b];
+            reader.ReadVector(reg.freq_list);
+            reader.ReadTensor(reg.excitation_mag_matrix);
+            reader.ReadTensor(reg.excitation_phase_matrix);
+        }
+        auto& irreg = data.irreg_wave_data_[b];
+        if (data.loaded_.irregular_excitation) {
+            reader.ReadVector(irreg.freq_list);
+            reader.ReadMatrix(irreg.excitation_re_matrix);
+            reader.ReadMatrix(irreg.excitation_im_matrix);
+        }
+        if (data.loaded_.excitation_irf) {
+            reader.ReadVector(irreg.excitation_irf_time);
+            reader.ReadMatrix(irreg.excitation_irf_matrix);
+        }
+    }
+    if (!reader.AtEnd()) {
+        reader.Fail();
+    }
+    return data;
+}
+
+bool HydroDatabase::IsDatabase(const std::string& file_name) {
+    std::ifstream file(file_name, std::ios::binary);
+    char magic[sizeof(kDatabaseMagic)];
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, kDatabaseMagic, sizeof(magic)) == 0;
+}
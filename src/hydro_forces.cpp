@@ -8,7 +8,10 @@
 // TODO minimize include statements, move all to header file hydro_forces.h?
 #include "hydroc/hydro_forces.h"
 #include <hydroc/chloadaddedmass.h>
+#include <hydroc/chloadhydroforces.h>
 #include <hydroc/h5fileinfo.h>
+#include <hydroc/hydro_data_cache.h>
+#include <hydroc/radiation_convolution.h>
 #include <hydroc/wave_types.h>
 
 #include <chrono/physics/ChLoad.h>
@@ -163,37 +166,38 @@ void ForceFunc6d::ApplyForceAndTorqueToBody() {
 TestHydro::TestHydro(std::vector<std::shared_ptr<ChBody>> user_bodies,
                      std::string h5_file_name,
                      std::shared_ptr<WaveBase> waves)
-    : bodies_(user_bodies),
-      num_bodies_(bodies_.size()),
-      file_info_(H5FileInfo(h5_file_name, num_bodies_).ReadH5Data()) {
-    prev_time = -1;
+    : TestHydro(user_bodies,
+                std::make_shared<HydroData>(
+                    HydroDataCache::Load(h5_file_name, user_bodies.size(), waves->GetHydroDataRequirements())),
+                waves) {
+    // created non-const above and not shared: completed in place by AddWaves()
+    owned_file_info_ = std::const_pointer_cast<HydroData>(file_info_);
+}
 
-    // Set up time vector
-    rirf_time_vector = file_info_.GetRIRFTimeVector();
-    // width array
-    rirf_width_vector.resize(rirf_time_vector.size());
-    for (int ii = 0; ii < rirf_width_vector.size(); ii++) {
-        rirf_width_vector[ii] = 0.0;
-        if (ii < rirf_time_vector.size() - 1) {
-            rirf_width_vector[ii] += 0.5 * abs(rirf_time_vector[ii + 1] - rirf_time_vector[ii]);
-        }
-        if (ii > 0) {
-            rirf_width_vector[ii] += 0.5 * abs(rirf_time_vector[ii] - rirf_time_vector[ii - 1]);
-        }
+TestHydro::TestHydro(std::vector<std::shared_ptr<ChBody>> user_bodies,
+                     std::shared_ptr<const HydroData> hydro_data,
+                     std::shared_ptr<WaveBase> waves)
+    : bodies_(user_bodies), num_bodies_(bodies_.size()), file_info_(hydro_data) {
+    if (file_info_ == nullptr || static_cast<int>(file_info_->GetBodyInfos().size()) != num_bodies_) {
+        throw std::invalid_argument("TestHydro: the hydro data does not have one entry per hydro body.");
     }
+    prev_time = -1;
 
     // Total degrees of freedom
     int total_dofs = kDofPerBody * num_bodies_;
 
+    // Set up radiation kernel and velocity history, sized from the system step if already set
+    InitializeRadiationCoupling();
+    InitializeRadiationKernel();
+    position_sample_.setZero(total_dofs);
+    velocity_sample_.setZero(total_dofs);
+    ResetVelocityHistory(bodies_[0]->GetSystem()->GetStep());
+
     // Initialize vectors
-    time_history_.clear();
-    velocity_history_.clear();
-    for (int b = 0; b < num_bodies_; ++b) {
-        velocity_history_.push_back(std::vector<std::vector<double>>(0));
-    }
     force_hydrostatic_.assign(total_dofs, 0.0);
     force_radiation_damping_.assign(total_dofs, 0.0);
     total_force_.assign(total_dofs, 0.0);
+    force_waves_.setZero(total_dofs);
     equilibrium_.assign(total_dofs, 0.0);
     cb_minus_cg_.assign(kDofLinOrRot * num_bodies_, 0.0);
 
@@ -203,16 +207,12 @@ TestHydro::TestHydro(std::vector<std::shared_ptr<ChBody>> user_bodies,
             unsigned eq_idx = i + kDofPerBody * b;
             unsigned c_idx  = i + kDofLinOrRot * b;
 
-            equilibrium_[eq_idx] = file_info_.GetCGVector(b)[i];
-            cb_minus_cg_[c_idx]  = file_info_.GetCBVector(b)[i] - file_info_.GetCGVector(b)[i];
+            equilibrium_[eq_idx] = file_info_->GetCGVector(b)[i];
+            cb_minus_cg_[c_idx]  = file_info_->GetCBVector(b)[i] - file_info_->GetCGVector(b)[i];
         }
     }
 
-    for (int b = 0; b < num_bodies_; ++b) {
-        force_per_body_.emplace_back(bodies_[b], this);
-    }
-
-    // Handle added mass info
+    // Added mass and hydro forces, applied to all hydro bodies by one load each
     my_loadcontainer = chrono_types::make_shared<ChLoadContainer>();
 
     std::vector<std::shared_ptr<ChLoadable>> loadables(bodies_.size());
@@ -221,28 +221,108 @@ TestHydro::TestHydro(std::vector<std::shared_ptr<ChBody>> user_bodies,
     }
 
     my_loadbodyinertia =
-        chrono_types::make_shared<ChLoadAddedMass>(file_info_.GetBodyInfos(), loadables, bodies_[0]->GetSystem());
+        chrono_types::make_shared<ChLoadAddedMass>(file_info_->GetBodyInfos(), loadables, bodies_[0]->GetSystem());
+
+    UpdateHydroLoadJacobian();
+    my_loadhydroforces = chrono_types::make_shared<ChLoadHydroForces>(this, loadables);
 
     bodies_[0]->GetSystem()->Add(my_loadcontainer);
     my_loadcontainer->Add(my_loadbodyinertia);
+    my_loadcontainer->Add(my_loadhydroforces);
 
     // Set up hydro inputs
     user_waves_ = waves;
     AddWaves(user_waves_);
 }
 
+void TestHydro::SetRadiationParams(const RadiationParams& params) {
+    GetRadiationNumThreads(params.num_threads_);  // throws if invalid
+    radiation_params_ = params;
+
+    double step = bodies_[0]->GetSystem()->GetStep();
+    if (radiation_params_.mode_ == RadiationMode::convolutionFixedStep ||
+        radiation_params_.mode_ == RadiationMode::convolutionFFT) {
+        if (radiation_params_.timestep_ <= 0.0) {
+            radiation_params_.timestep_ = step;
+        }
+        if (radiation_params_.timestep_ <= 0.0) {
+            throw std::invalid_argument("Fixed step radiation convolution requires a positive time step.");
+        }
+        step = radiation_params_.timestep_;
+    }
+
+    InitializeRadiationCoupling();
+    radiation_fit_report_.clear();
+    if (radiation_params_.mode_ == RadiationMode::stateSpace) {
+        InitializeRadiationStateSpace();
+        radiation_instantaneous_.setZero();
+    } else if (radiation_params_.mode_ == RadiationMode::stateSpaceFit) {
+        InitializeRadiationStateSpaceFit();
+        radiation_instantaneous_.setZero();
+    } else {
+        InitializeRadiationKernel();
+        ResetVelocityHistory(step);
+
+        if (radiation_params_.mode_ == RadiationMode::convolutionFFT) {
+            radiation_fft_.Initialize(radiation_kernel_, kDofPerBody * num_bodies_, radiation_params_.timestep_,
+                                      radiation_params_.fft_block_size_);
+        }
+    }
+
+    UpdateHydroLoadJacobian();
+}
+
+bool TestHydro::IsRadiationHistoryUniform() const {
+    const int history_size = velocity_history_.Size();
+    return radiation_params_.mode_ == RadiationMode::convolutionFixedStep && history_size > 1 &&
+           uniform_history_size_ >= std::min(history_size, static_cast<int>(rirf_time_vector.size()));
+}
+
+void TestHydro::SetImplicitHydrostatics(bool implicit) {
+    implicit_hydrostatics_ = implicit;
+    UpdateHydroLoadJacobian();
+}
+
+void TestHydro::SetImplicitRadiation(bool implicit) {
+    implicit_radiation_ = implicit;
+    UpdateHydroLoadJacobian();
+}
+
+void TestHydro::UpdateHydroLoadJacobian() {
+    my_loadbodyinertia->SetHydrostaticStiffness(implicit_hydrostatics_ ? file_info_->GetRhoVal() : 0.0);
+    if (implicit_radiation_) {
+        my_loadbodyinertia->SetRadiationDamping(radiation_instantaneous_);
+    } else {
+        my_loadbodyinertia->SetRadiationDamping(ChMatrixDynamic<double>());
+    }
+}
+
 void TestHydro::AddWaves(std::shared_ptr<WaveBase> waves) {
     user_waves_ = waves;
 
+    // excitation data of the new waves, if it was not read with the h5 file, read in place into private data and into
+    // a private copy of shared data
+    const HydroDataRequirements& loaded  = file_info_->GetLoadedRequirements();
+    const HydroDataRequirements required = user_waves_->GetHydroDataRequirements();
+    if ((required.regular_excitation && !loaded.regular_excitation) ||
+        (required.irregular_excitation && !loaded.irregular_excitation) ||
+        (required.excitation_irf && !loaded.excitation_irf)) {
+        if (owned_file_info_ == nullptr) {
+            owned_file_info_ = std::make_shared<HydroData>(*file_info_);
+            file_info_       = owned_file_info_;
+        }
+        owned_file_info_->Require(required);
+    }
+
     switch (user_waves_->GetWaveMode()) {
         case WaveMode::regular: {
             auto reg = std::static_pointer_cast<RegularWave>(user_waves_);
-            reg->AddH5Data(file_info_.GetRegularWaveInfos());
+            reg->AddH5Data(file_info_->GetRegularWaveInfos());
             break;
         }
         case WaveMode::irregular: {
             auto irreg = std::static_pointer_cast<IrregularWaves>(user_waves_);
-            irreg->AddH5Data(file_info_.GetIrregularWaveInfos(), file_info_.GetSimulationInfo());
+            irreg->AddH5Data(file_info_->GetIrregularWaveInfos(), file_info_->GetSimulationInfo());
             break;
         }
     }
@@ -250,37 +330,32 @@ void TestHydro::AddWaves(std::shared_ptr<WaveBase> waves) {
     user_waves_->Initialize();
 }
 
-std::vector<double> TestHydro::ComputeForceHydrostatics() {
+const std::vector<double>& TestHydro::ComputeForceHydrostatics() {
     assert(num_bodies_ > 0);
 
-    const double rho = file_info_.GetRhoVal();
+    const double rho = file_info_->GetRhoVal();
     const auto g_acc = bodies_[0]->GetSystem()->Get_G_acc();  // assuming all bodies in same system
     const double gg  = g_acc.Length();
 
     for (int b = 0; b < num_bodies_; b++) {
-        std::shared_ptr<chrono::ChBody> body = bodies_[b];
-
         int b_offset                   = kDofPerBody * b;
         double* body_force_hydrostatic = &force_hydrostatic_[b_offset];
         double* body_equilibrium       = &equilibrium_[b_offset];
 
-        // hydrostatic stiffness due to offset from equilibrium
-        const auto body_position = body->GetPos();
-        const auto body_rotation = body->GetRot().Q_to_Euler123();
-
+        // hydrostatic stiffness due to offset from equilibrium (position and Euler123 rotation)
         chrono::ChVectorN<double, kDofPerBody> body_displacement;
-        for (int ii = 0; ii < kDofLinOrRot; ii++) {
-            body_displacement[ii]                = body_position[ii] - body_equilibrium[ii];
-            body_displacement[ii + kDofLinOrRot] = body_rotation[ii] - body_equilibrium[ii + kDofLinOrRot];
+        for (int ii = 0; ii < kDofPerBody; ii++) {
+            body_displacement[ii] = position_sample_[b_offset + ii] - body_equilibrium[ii];
         }
 
-        const auto force_offset = -gg * rho * file_info_.GetLinMatrix(b) * body_displacement;
+        chrono::ChVectorN<double, kDofPerBody> force_offset;
+        force_offset.noalias() = (-gg * rho) * file_info_->GetLinMatrix(b) * body_displacement;
         for (int dof = 0; dof < kDofPerBody; dof++) {
             body_force_hydrostatic[dof] += force_offset[dof];
         }
 
         // buoyancy at equilibrium
-        const auto buoyancy = rho * (-g_acc) * file_info_.GetDispVolVal(b);
+        const auto buoyancy = rho * (-g_acc) * file_info_->GetDispVolVal(b);
 
         for (int ii = 0; ii < kDofLinOrRot; ii++) {
             body_force_hydrostatic[ii] += buoyancy[ii];
@@ -299,8 +374,8 @@ std::vector<double> TestHydro::ComputeForceHydrostatics() {
     return force_hydrostatic_;
 }
 
-std::vector<double> TestHydro::ComputeForceRadiationDampingConv() {
-    const int size    = file_info_.GetRIRFDims(2);
+const std::vector<double>& TestHydro::ComputeForceRadiationDampingConv() {
+    const int size    = rirf_time_vector.size();
     const int numRows = kDofPerBody * num_bodies_;
     const int numCols = kDofPerBody * num_bodies_;
 
@@ -309,93 +384,338 @@ std::vector<double> TestHydro::ComputeForceRadiationDampingConv() {
     // time history
     auto t_sim = bodies_[0]->GetChTime();
     auto t_min = t_sim - rirf_time_vector.tail<1>()[0];
-    if (time_history_.size() > 0 && t_sim == time_history_.front()) {
+    if (velocity_history_.Size() > 0 && t_sim == velocity_history_.Time(0)) {
         throw std::runtime_error("Tried to compute the radiation damping convolution twice within the same time step!");
     }
-    time_history_.insert(time_history_.begin(), t_sim);
 
     // velocity history
-    for (int b = 0; b < num_bodies_; b++) {
-        auto& body                  = bodies_[b];
-        auto& velocity_history_body = velocity_history_[b];
+    velocity_history_.Push(t_sim, velocity_sample_);
 
-        auto vel                    = body->GetPos_dt();
-        auto wvel                   = body->GetWvel_par();
-        std::vector<double> vel_vec = {vel[0], vel[1], vel[2], wvel[0], wvel[1], wvel[2]};
-        velocity_history_body.insert(velocity_history_body.begin(), vel_vec);
+    // most recent lag, applied to the current velocities (the convolution below adds the older lags). Explicitly, the
+    // first sample alone gives no force, as in the convolution over the whole history
+    if (implicit_radiation_ || velocity_history_.Size() > 1) {
+        Eigen::Map<Eigen::VectorXd> instantaneous(force_radiation_damping_.data(), numRows);
+        instantaneous.noalias() = radiation_instantaneous_ * velocity_sample_;
     }
 
     // remove unnecessary history
-    if (time_history_.size() > 1) {
-        while (time_history_[time_history_.size() - 2] < t_min) {
-            time_history_.pop_back();
-            for (int b = 0; b < num_bodies_; b++) {
-                auto& velocity_history_body = velocity_history_[b];
-                velocity_history_body.pop_back();
-            }
+    while (velocity_history_.Size() > 1 && velocity_history_.Time(velocity_history_.Size() - 2) < t_min) {
+        velocity_history_.PopOldest();
+    }
+
+    const int history_size = velocity_history_.Size();
+
+    // fixed step: history sample k is the velocity at RIRF time step k if the newest samples are evenly spaced
+    if (radiation_params_.mode_ == RadiationMode::convolutionFixedStep) {
+        const double dt = radiation_params_.timestep_;
+        if (history_size > 1 && std::abs(t_sim - velocity_history_.Time(1) - dt) <= 1e-6 * dt) {
+            uniform_history_size_ = std::min(uniform_history_size_ + 1, history_size);
+        } else {
+            // the newest sample alone, e.g. the first one after a reset
+            uniform_history_size_ = 1;
+        }
+
+        const int num_lags = std::min(history_size, size);
+        if (history_size > 1 && uniform_history_size_ >= num_lags) {
+            Eigen::Map<Eigen::VectorXd> force(force_radiation_damping_.data(), numRows);
+            AddRadiationConvolution(radiation_kernel_, size, velocity_history_.Window(num_lags),
+                                    radiation_coupling_.cols, force, radiation_params_.num_threads_);
+            return force_radiation_damping_;
         }
     }
 
-    if (time_history_.size() > 1) {
+    if (history_size > 1) {
         int idx_history = 0;
+        int step        = 0;
 
-        // iterate over RIRF steps
-        for (int step = 0; step < size; step++) {
+        // interpolate velocities at each RIRF step from recorded velocity history
+        for (; step < size; step++) {
             auto t_rirf = t_sim - rirf_time_vector[step];
-            while (time_history_[idx_history + 1] > t_rirf && idx_history < time_history_.size() - 1) {
+            while (idx_history < history_size - 1 && velocity_history_.Time(idx_history + 1) > t_rirf) {
                 idx_history += 1;
             }
-            if (idx_history >= time_history_.size() - 1) {
+            if (idx_history >= history_size - 1) {
                 break;
             }
 
-            // iterate over bodies
-            for (int idx_body = 0; idx_body < num_bodies_; idx_body++) {
-                auto& velocity_history_body = velocity_history_[idx_body];
-                std::vector<double> vel(kDofPerBody);
-
-                // interpolate velocity at t_rirf from recorded velocity history
-                // time values
-                auto t1 = time_history_[idx_history + 1];
-                auto t2 = time_history_[idx_history];
-                if (t_rirf == t1) {
-                    vel = velocity_history_body[idx_history + 1];
-                } else if (t_rirf == t2) {
-                    vel = velocity_history_body[idx_history];
-                } else if (t_rirf > t1 && t_rirf < t2) {
-                    // weights
-                    auto w1 = (t2 - t_rirf) / (t2 - t1);
-                    auto w2 = 1.0 - w1;
-                    // velocity values
-                    auto vel1 = velocity_history_body[idx_history + 1];
-                    auto vel2 = velocity_history_body[idx_history];
-                    for (int dof = 0; dof < kDofPerBody; dof++) {
-                        vel[dof] = w1 * vel1[dof] + w2 * vel2[dof];
+            // time values
+            auto t1 = velocity_history_.Time(idx_history + 1);
+            auto t2 = velocity_history_.Time(idx_history);
+            if (t_rirf == t1) {
+                for (int col = 0; col < numCols; col++) {
+                    lagged_velocity_(step, col) = velocity_history_.Value(idx_history + 1, col);
+                }
+            } else if (t_rirf == t2) {
+                for (int col = 0; col < numCols; col++) {
+                    lagged_velocity_(step, col) = velocity_history_.Value(idx_history, col);
+                }
+            } else if (t_rirf > t1 && t_rirf < t2) {
+                // weights
+                auto w1 = (t2 - t_rirf) / (t2 - t1);
+                auto w2 = 1.0 - w1;
+                for (int col = 0; col < numCols; col++) {
+                    lagged_velocity_(step, col) = w1 * velocity_history_.Value(idx_history + 1, col) +
+                                                  w2 * velocity_history_.Value(idx_history, col);
+                }
+            } else {
+                throw std::runtime_error("Radiation convolution: wrong interpolation: " + std::to_string(t_rirf) +
+                                         " not between " + std::to_string(t1) + " and " + std::to_string(t2) + ".");
+            }
+        }
+
+        // RIRF steps older than the recorded history do not contribute
+        lagged_velocity_.bottomRows(size - step).setZero();
+
+        // convolution: rho, the RIRF and the integration widths are all folded in the kernel
+        Eigen::Map<Eigen::VectorXd> force(force_radiation_damping_.data(), numRows);
+        AddRadiationConvolution(radiation_kernel_, size, lagged_velocity_, radiation_coupling_.cols, force,
+                                radiation_params_.num_threads_);
+    }
+    return force_radiation_damping_;
+}
+
+const std::vector<double>& TestHydro::ComputeForceRadiationDampingStateSpace() {
+    const auto& force = radiation_state_space_.Advance(bodies_[0]->GetChTime(), velocity_sample_);
+    std::copy(force.data(), force.data() + force.size(), force_radiation_damping_.begin());
+    return force_radiation_damping_;
+}
+
+const std::vector<double>& TestHydro::ComputeForceRadiationDampingFFT() {
+    const auto& force = radiation_fft_.Advance(bodies_[0]->GetChTime(), velocity_sample_);
+    Eigen::Map<Eigen::VectorXd> damping(force_radiation_damping_.data(), force_radiation_damping_.size());
+    damping = force;
+
+    // most recent lag, explicitly without force from the first sample alone as in the fixed step convolution
+    if (implicit_radiation_ || radiation_fft_.GetNumSamples() > 1) {
+        damping.noalias() += radiation_instantaneous_ * velocity_sample_;
+    }
+    return force_radiation_damping_;
+}
+
+void TestHydro::UpdateBodyStateSample() {
+    for (int b = 0; b < num_bodies_; b++) {
+        auto& body = bodies_[b];
+        auto pos   = body->GetPos();
+        auto rot   = body->GetRot().Q_to_Euler123();
+        auto vel   = body->GetPos_dt();
+        auto wvel  = body->GetWvel_par();
+        for (int ii = 0; ii < kDofLinOrRot; ii++) {
+            position_sample_[kDofPerBody * b + ii]                = pos[ii];
+            position_sample_[kDofPerBody * b + ii + kDofLinOrRot] = rot[ii];
+            velocity_sample_[kDofPerBody * b + ii]                = vel[ii];
+            velocity_sample_[kDofPerBody * b + ii + kDofLinOrRot] = wvel[ii];
+        }
+    }
+}
+
+void TestHydro::InitializeRadiationStateSpace() {
+    if (!file_info_->HasRadiationStateSpace()) {
+        throw std::runtime_error(
+            "State space radiation requires a state space realization of the RIRF in the h5 file "
+            "(hydro_coeffs/radiation_damping/state_space for every body).");
+    }
+
+    const int total_dofs = kDofPerBody * num_bodies_;
+    radiation_state_space_.Clear(total_dofs);
+    for (int b = 0; b < num_bodies_; b++) {
+        const auto& ss = file_info_->GetRadiationStateSpace(b);
+        for (int dof = 0; dof < kDofPerBody; dof++) {
+            int row = dof + b * kDofPerBody;
+            for (int col = 0; col < total_dofs; col++) {
+                const int order = ss.order(dof, col);
+                if ((order <= 0 && ss.D(dof, col) == 0.0) || !radiation_coupling_.IsKept(row, col)) {
+                    continue;
+                }
+                Eigen::MatrixXd A(order, order);
+                Eigen::VectorXd B(order);
+                Eigen::RowVectorXd C(order);
+                for (int ii = 0; ii < order; ii++) {
+                    for (int jj = 0; jj < order; jj++) {
+                        A(ii, jj) = ss.A(dof, col, ii, jj);
                     }
-                } else {
-                    throw std::runtime_error("Radiation convolution: wrong interpolation: " + std::to_string(t_rirf) +
-                                             " not between " + std::to_string(t1) + " and " + std::to_string(t2) + ".");
+                    B[ii] = ss.B(dof, col, ii, 0);
+                    C[ii] = ss.C(dof, col, 0, ii);
+                }
+                radiation_state_space_.AddKernel(row, col, A, B, C, ss.D(dof, col));
+            }
+        }
+    }
+}
+
+void TestHydro::InitializeRadiationStateSpaceFit() {
+    if (radiation_params_.fit_tolerance_ <= 0.0 || radiation_params_.fit_max_order_ < 1) {
+        throw std::invalid_argument("RIRF fit requires a positive tolerance and maximum order.");
+    }
+
+    // the identification needs uniformly sampled kernels
+    const Eigen::VectorXd h5_time_vector = file_info_->GetRIRFTimeVector();
+    const int size                       = h5_time_vector.size();
+    const double dt                      = (h5_time_vector[size - 1] - h5_time_vector[0]) / (size - 1);
+    for (int step = 1; step < size; step++) {
+        if (std::abs(h5_time_vector[step] - h5_time_vector[step - 1] - dt) > 1e-6 * dt) {
+            throw std::runtime_error("RIRF fit requires a uniformly sampled RIRF time vector.");
+        }
+    }
+
+    const int total_dofs = kDofPerBody * num_bodies_;
+    std::vector<Eigen::VectorXd> kernels(total_dofs * total_dofs, Eigen::VectorXd(size));
+    double scale = 0.0;
+    for (int b = 0; b < num_bodies_; b++) {
+        for (int dof = 0; dof < kDofPerBody; dof++) {
+            int row = dof + b * kDofPerBody;
+            for (int col = 0; col < total_dofs; col++) {
+                auto& samples = kernels[row * total_dofs + col];
+                for (int step = 0; step < size; step++) {
+                    samples[step] = file_info_->GetRIRFVal(b, dof, col, step);
+                }
+                scale = std::max(scale, samples.norm());
+            }
+        }
+    }
+
+    // errors are relative to the largest kernel, so that negligible kernels are dropped
+    radiation_state_space_.Clear(total_dofs);
+    double max_error = 0.0;
+    for (int row = 0; row < total_dofs; row++) {
+        for (int col = 0; col < total_dofs; col++) {
+            if (!radiation_coupling_.IsKept(row, col)) {
+                continue;
+            }
+            auto fit = FitRIRFKernel(kernels[row * total_dofs + col], dt, radiation_params_.fit_tolerance_,
+                                     radiation_params_.fit_max_order_, scale);
+            max_error = std::max(max_error, fit.error);
+            if (fit.order == 0) {
+                continue;
+            }
+            radiation_state_space_.AddKernel(row, col, fit.A, fit.B, fit.C, 0.0);
+            radiation_fit_report_.push_back({row, col, fit.order, fit.error});
+        }
+    }
+
+    std::cout << "RIRF fit: " << radiation_fit_report_.size() << " kernels, "
+              << radiation_state_space_.GetNumStates() << " states, max relative error " << max_error << std::endl;
+}
+
+void TestHydro::InitializeRadiationCoupling() {
+    const int total_dofs = kDofPerBody * num_bodies_;
+    const int size       = file_info_->GetRIRFDims(2);
+
+    Eigen::MatrixXd norms(total_dofs, total_dofs);
+    for (int b = 0; b < num_bodies_; b++) {
+        for (int dof = 0; dof < kDofPerBody; dof++) {
+            int row = dof + b * kDofPerBody;
+            for (int col = 0; col < total_dofs; col++) {
+                double sum = 0.0;
+                for (int step = 0; step < size; step++) {
+                    double value = file_info_->GetRIRFVal(b, dof, col, step);
+                    sum += value * value;
                 }
+                norms(row, col) = std::sqrt(sum);
+            }
+        }
+    }
 
-                for (int dof = 0; dof < kDofPerBody; dof++) {
-                    // get column index
-                    int col = dof + idx_body * kDofPerBody;
+    radiation_coupling_ = BuildRadiationCouplingMap(norms, kDofPerBody, radiation_params_.prune_tolerance_,
+                                                    radiation_params_.body_interactions_);
+
+    const auto& map = radiation_coupling_;
+    if (map.num_kept < map.num_kernels) {
+        std::cout << "Radiation coupling: " << map.num_kept << " of " << map.num_kernels << " kernels kept ("
+                  << map.num_zero << " zero, " << map.num_negligible << " below tolerance, " << map.num_uncoupled
+                  << " not interacting), " << map.num_body_blocks_kept << " of " << map.num_body_blocks
+                  << " body blocks, largest pruned kernel " << map.max_pruned_norm << std::endl;
+    }
+}
 
-                    // iterate over rows
-                    for (int row = 0; row < numRows; row++) {
-                        force_radiation_damping_[row] +=
-                            GetRIRFval(row, col, step) * vel[dof] * rirf_width_vector[step];
+void TestHydro::InitializeRadiationKernel() {
+    const int total_dofs = kDofPerBody * num_bodies_;
+
+    // Set up time vector, either the h5 RIRF time steps or the multiples of the fixed time step
+    const Eigen::VectorXd h5_time_vector = file_info_->GetRIRFTimeVector();
+    if (radiation_params_.mode_ == RadiationMode::convolutionFixedStep ||
+        radiation_params_.mode_ == RadiationMode::convolutionFFT) {
+        const double dt = radiation_params_.timestep_;
+        const int size  = static_cast<int>(std::floor(h5_time_vector.tail<1>()[0] / dt + 1e-9)) + 1;
+        rirf_time_vector.resize(size);
+        for (int ii = 0; ii < size; ii++) {
+            rirf_time_vector[ii] = ii * dt;
+        }
+    } else {
+        rirf_time_vector = h5_time_vector;
+    }
+    const int size = rirf_time_vector.size();
+
+    // width array
+    rirf_width_vector.resize(size);
+    for (int ii = 0; ii < rirf_width_vector.size(); ii++) {
+        rirf_width_vector[ii] = 0.0;
+        if (ii < rirf_time_vector.size() - 1) {
+            rirf_width_vector[ii] += 0.5 * abs(rirf_time_vector[ii + 1] - rirf_time_vector[ii]);
+        }
+        if (ii > 0) {
+            rirf_width_vector[ii] += 0.5 * abs(rirf_time_vector[ii] - rirf_time_vector[ii - 1]);
+        }
+    }
+
+    // h5 step index and interpolation weight of the next h5 step for each RIRF time (exact if the time vectors match)
+    std::vector<int> h5_index(size);
+    std::vector<double> h5_weight(size);
+    int idx = 0;
+    for (int step = 0; step < size; step++) {
+        while (idx < h5_time_vector.size() - 2 && h5_time_vector[idx + 1] <= rirf_time_vector[step]) {
+            idx += 1;
+        }
+        double t1       = h5_time_vector[idx];
+        double t2       = h5_time_vector[std::min<int>(idx + 1, h5_time_vector.size() - 1)];
+        h5_index[step]  = idx;
+        h5_weight[step] = (t2 > t1) ? std::clamp((rirf_time_vector[step] - t1) / (t2 - t1), 0.0, 1.0) : 0.0;
+    }
+    const int h5_last = file_info_->GetRIRFDims(2) - 1;
+
+    radiation_kernel_.setZero(total_dofs, total_dofs * size);
+    for (int b = 0; b < num_bodies_; b++) {
+        for (int dof = 0; dof < kDofPerBody; dof++) {
+            int row = dof + b * kDofPerBody;
+            for (int col : radiation_coupling_.cols[row]) {
+                for (int step = 0; step < size; step++) {
+                    int s1       = h5_index[step];
+                    double w2    = h5_weight[step];
+                    double value = file_info_->GetRIRFVal(b, dof, col, s1);
+                    if (w2 > 0.0) {
+                        value = (1.0 - w2) * value +
+                                w2 * file_info_->GetRIRFVal(b, dof, col, std::min(s1 + 1, h5_last));
                     }
+                    radiation_kernel_(row, col * size + step) = value * rirf_width_vector[step];
                 }
             }
         }
     }
-    return force_radiation_damping_;
+
+    // the first RIRF step only depends on the current velocities, it is applied as a damping matrix
+    radiation_instantaneous_.resize(total_dofs, total_dofs);
+    for (int col = 0; col < total_dofs; col++) {
+        radiation_instantaneous_.col(col) = radiation_kernel_.col(col * size);
+        radiation_kernel_.col(col * size).setZero();
+    }
+
+    lagged_velocity_.setZero(size, total_dofs);
+}
+
+void TestHydro::ResetVelocityHistory(double step) {
+    // sized to hold a full RIRF window, plus the sample older than the window and the newly pushed sample, so that no
+    // reallocation is needed during the simulation
+    int history_capacity = rirf_time_vector.size() + 2;
+    if (step > 0.0) {
+        int steps_per_rirf = static_cast<int>(std::ceil(rirf_time_vector.tail<1>()[0] / step));
+        history_capacity   = std::max(history_capacity, steps_per_rirf + 3);
+    }
+    velocity_history_.Reset(kDofPerBody * num_bodies_, history_capacity);
+    uniform_history_size_ = 0;
 }
 
 double TestHydro::GetRIRFval(int row, int col, int st) {
     if (row < 0 || row >= kDofPerBody * num_bodies_ || col < 0 || col >= kDofPerBody * num_bodies_ || st < 0 ||
-        st >= file_info_.GetRIRFDims(2)) {
+        st >= file_info_->GetRIRFDims(2)) {
         throw std::out_of_range("rirfval index out of range in TestHydro");
     }
 
@@ -403,26 +723,94 @@ double TestHydro::GetRIRFval(int row, int col, int st) {
     int col_dof    = col % kDofPerBody;
     int row_dof    = row % kDofPerBody;
 
-    return file_info_.GetRIRFVal(body_index, row_dof, col, st);
+    return file_info_->GetRIRFVal(body_index, row_dof, col, st);
 }
 
-Eigen::VectorXd TestHydro::ComputeForceWaves() {
+const Eigen::VectorXd& TestHydro::ComputeForceWaves() {
     // Ensure bodies_ is not empty
     if (bodies_.empty()) {
         throw std::runtime_error("bodies_ array is empty in ComputeForceWaves");
     }
 
-    force_waves_ = user_waves_->GetForceAtTime(bodies_[0]->GetChTime());
-
-    // TODO: Add size check for force_waves_ if needed
-    // Example:
-    // if (force_waves_.size() != expected_size) {
-    //     throw std::runtime_error("Mismatched size in ComputeForceWaves");
-    // }
+    // written in place, the wave classes check the size
+    user_waves_->GetForceAtTime(bodies_[0]->GetChTime(), force_waves_);
 
     return force_waves_;
 }
 
+const std::vector<double>& TestHydro::ComputeTotalForce(const Eigen::Ref<const Eigen::VectorXd>& positions,
+                                                        const Eigen::Ref<const Eigen::VectorXd>& velocities) {
+    const int total_dofs = kDofPerBody * num_bodies_;
+    if (positions.size() != total_dofs || velocities.size() != total_dofs) {
+        throw std::invalid_argument("ComputeTotalForce: expected " + std::to_string(total_dofs) +
+                                    " positions and velocities.");
+    }
+
+    // Check if the forces for this time step have already been computed
+    if (bodies_[0]->GetChTime() != prev_time) {
+        position_sample_ = positions;
+        velocity_sample_ = velocities;
+        UpdateTotalForce();
+    } else {
+        // iteration of an implicit integrator: only the hydrostatics and the instantaneous radiation damping follow
+        // the states, the radiation history and the waves stay at the first evaluation of the step
+        bool changed = false;
+        if (implicit_hydrostatics_ && position_sample_ != positions) {
+            position_sample_ = positions;
+            std::fill(force_hydrostatic_.begin(), force_hydrostatic_.end(), 0.0);
+            ComputeForceHydrostatics();
+            changed = true;
+        }
+        if (implicit_radiation_ && velocity_sample_ != velocities) {
+            Eigen::Map<Eigen::VectorXd> damping(force_radiation_damping_.data(), total_dofs);
+            damping.noalias() -= radiation_instantaneous_ * velocity_sample_;
+            velocity_sample_ = velocities;
+            damping.noalias() += radiation_instantaneous_ * velocity_sample_;
+            changed = true;
+        }
+        if (changed) {
+            AccumulateTotalForce();
+        }
+    }
+    return total_force_;
+}
+
+void TestHydro::UpdateTotalForce() {
+    // Update time and reset forces for this time step
+    prev_time = bodies_[0]->GetChTime();
+    std::fill(total_force_.begin(), total_force_.end(), 0.0);
+    std::fill(force_hydrostatic_.begin(), force_hydrostatic_.end(), 0.0);
+    std::fill(force_radiation_damping_.begin(), force_radiation_damping_.end(), 0.0);
+    std::fill(force_waves_.begin(), force_waves_.end(), 0.0);
+
+    // each component is computed in place into its member vector, in this order
+    ComputeForceHydrostatics();
+    switch (radiation_params_.mode_) {
+        case RadiationMode::stateSpace:
+        case RadiationMode::stateSpaceFit:
+            ComputeForceRadiationDampingStateSpace();
+            break;
+        case RadiationMode::convolutionFFT:
+            ComputeForceRadiationDampingFFT();
+            break;
+        default:
+            ComputeForceRadiationDampingConv();
+            break;
+    }
+    ComputeForceWaves();
+
+    AccumulateTotalForce();
+}
+
+void TestHydro::AccumulateTotalForce() {
+    const int total_dofs = kDofPerBody * num_bodies_;
+
+    // Accumulate total force (consider converting forces to Eigen::VectorXd in the future for direct addition)
+    for (int index = 0; index < total_dofs; index++) {
+        total_force_[index] = force_hydrostatic_[index] - force_radiation_damping_[index] + force_waves_[index];
+    }
+}
+
 double TestHydro::CoordinateFuncForBody(int b, int dof_index) {
     if (dof_index < 0 || dof_index >= kDofPerBody || b < 1 || b > num_bodies_) {
         throw std::out_of_range("Invalid index in CoordinateFuncForBody");
@@ -442,21 +830,8 @@ double TestHydro::CoordinateFuncForBody(int b, int dof_index) {
         return total_force_[body_num_offset + dof_index];
     }
 
-    // Update time and reset forces for this time step
-    prev_time = bodies_[0]->GetChTime();
-    std::fill(total_force_.begin(), total_force_.end(), 0.0);
-    std::fill(force_hydrostatic_.begin(), force_hydrostatic_.end(), 0.0);
-    std::fill(force_radiation_damping_.begin(), force_radiation_damping_.end(), 0.0);
-    std::fill(force_waves_.begin(), force_waves_.end(), 0.0);
-
-    force_hydrostatic_       = ComputeForceHydrostatics();
-    force_radiation_damping_ = ComputeForceRadiationDampingConv();
-    force_waves_             = ComputeForceWaves();
-
-    // Accumulate total force (consider converting forces to Eigen::VectorXd in the future for direct addition)
-    for (int index = 0; index < total_dofs; index++) {
-        total_force_[index] = force_hydrostatic_[index] - force_radiation_damping_[index] + force_waves_[index];
-    }
+    UpdateBodyStateSample();
+    UpdateTotalForce();
 
     if (body_num_offset + dof_index < 0 || body_num_offset >= total_dofs) {
         throw std::out_of_range("Accessing out-of-bounds index in CoordinateFuncForBody");
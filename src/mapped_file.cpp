@@ -0,0 +1,84 @@
+/*********************************************************************
+ * @file  mapped_file.cpp
+ *
+ * @brief implementation file for MappedFile (POSIX mmap, or file \
+ * mappings on Windows).
+ *********************************************************************/
+#include <hydroc/mapped_file.h>
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+std::shared_ptr<const MappedFile> MappedFile::Open(const std::string& file_name) {
+    std::shared_ptr<MappedFile> mapped(new MappedFile());
+#ifdef _WIN32
+    HANDLE file = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Unable to open file at: " + file_name + ".");
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw std::runtime_error("Unable to get the size of file " + file_name + ".");
+    }
+    mapped->size_ = static_cast<std::size_t>(size.QuadPart);
+    if (mapped->size_ > 0) {
+        // the view keeps the mapping alive after the handles are closed
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr) {
+            mapped->data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    const int file = open(file_name.c_str(), O_RDONLY);
+    if (file < 0) {
+        throw std::runtime_error("Unable to open file at: " + file_name + ".");
+    }
+    struct stat status;
+    if (fstat(file, &status) != 0) {
+        close(file);
+        throw std::runtime_error("Unable to get the size of file " + file_name + ".");
+    }
+    mapped->size_ = static_cast<std::size_t>(status.st_size);
+    if (mapped->size_ > 0) {
+        // the mapping stays valid after the file is closed
+        void* data = mmap(nullptr, mapped->size_, PROT_READ, MAP_SHARED, file, 0);
+        if (data != MAP_FAILED) {
+            mapped->data_ = static_cast<const char*>(data);
+        }
+    }
+    close(file);
+#endif
+    if (mapped->size_ > 0 && mapped->data_ == nullptr) {
+        throw std::runtime_error("Unable to map file " + file_name + " into memory.");
+    }
+    return mapped;
+}
+
+MappedFile::~MappedFile() {
+    if (data_ == nullptr) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+#else
+    munmap(const_cast<char*>(data_), size_);
+#endif
+}
@@ -0,0 +1,72 @@
+/*********************************************************************
+ * @file  radiation_convolution.cpp
+ *
+ * @brief implementation file for the multithreaded direct radiation \
+ * convolution.
+ *********************************************************************/
+#include <hydroc/radiation_convolution.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+int GetRadiationNumThreads(int num_threads) {
+    if (num_threads < 0) {
+        throw std::invalid_argument("Radiation convolution: invalid number of threads " + std::to_string(num_threads) +
+                                    ".");
+    }
+#ifdef _OPENMP
+    return num_threads == 0 ? omp_get_max_threads() : num_threads;
+#else
+    return 1;
+#endif
+}
+
+void AddRadiationConvolution(
+    const Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>& kernel,
+    int size,
+    const Eigen::Ref<const Eigen::MatrixXd>& velocities,
+    const std::vector<std::vector<int>>& coupling,
+    Eigen::Ref<Eigen::VectorXd> force,
+    int num_threads) {
+    const int num_rows = static_cast<int>(kernel.rows());
+    const int num_cols = static_cast<int>(velocities.cols());
+    const int num_lags = static_cast<int>(velocities.rows());
+    if (size <= 0 || kernel.cols() != static_cast<Eigen::Index>(num_cols) * size || num_lags > size ||
+        force.size() != num_rows || (!coupling.empty() && static_cast<int>(coupling.size()) != num_rows)) {
+        throw std::invalid_argument("Radiation convolution: kernel, velocities and force sizes do not match.");
+    }
+
+    const int num_blocks = (num_rows + kRadiationRowBlock - 1) / kRadiationRowBlock;
+    [[maybe_unused]] const int threads = std::min(GetRadiationNumThreads(num_threads), num_blocks);
+
+#pragma omp parallel for num_threads(threads) schedule(static) if (threads > 1)
+    for (int block = 0; block < num_blocks; block++) {
+        const int first = block * kRadiationRowBlock;
+        const int rows  = std::min(kRadiationRowBlock, num_rows - first);
+
+        bool dense = true;
+        for (int row = first; row < first + rows && !coupling.empty(); row++) {
+            dense = dense && static_cast<int>(coupling[row].size()) == num_cols;
+        }
+
+        Eigen::Matrix<double, Eigen::Dynamic, 1, 0, kRadiationRowBlock, 1> accumulated(rows);
+        accumulated.setZero();
+        if (dense) {
+            for (int col = 0; col < num_cols; col++) {
+                accumulated.noalias() += kernel.block(first, col * size, rows, num_lags) * velocities.col(col);
+            }
+        } else {
+            for (int ii = 0; ii < rows; ii++) {
+                for (int col : coupling[first + ii]) {
+                    accumulated[ii] += kernel.row(first + ii).segment(col * size, num_lags).dot(velocities.col(col));
+                }
+            }
+        }
+        force.segment(first, rows) += accumulated;
+    }
+}
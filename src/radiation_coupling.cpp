@@ -0,0 +1,73 @@
+/*********************************************************************
+ * @file  radiation_coupling.cpp
+ *
+ * @brief implementation file for the sparsity map of the RIRF kernels.
+ *********************************************************************/
+#include <hydroc/radiation_coupling.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+bool RadiationCouplingMap::IsKept(int row, int col) const {
+    const auto& kept = cols.at(row);
+    return std::binary_search(kept.begin(), kept.end(), col);
+}
+
+RadiationCouplingMap BuildRadiationCouplingMap(const Eigen::Ref<const Eigen::MatrixXd>& norms,
+                                               int dofs_per_body,
+                                               double tolerance,
+                                               const std::vector<std::pair<int, int>>& interactions) {
+    if (dofs_per_body <= 0 || norms.rows() != norms.cols() || norms.rows() % dofs_per_body != 0) {
+        throw std::invalid_argument("Radiation coupling: kernel norms must be 6N x 6N.");
+    }
+    if (tolerance < 0.0) {
+        throw std::invalid_argument("Radiation coupling: negative pruning tolerance.");
+    }
+    const int num_dofs   = static_cast<int>(norms.rows());
+    const int num_bodies = num_dofs / dofs_per_body;
+
+    // body interaction graph, all pairs if not given
+    Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> interacting;
+    interacting.setConstant(num_bodies, num_bodies, interactions.empty());
+    for (const auto& pair : interactions) {
+        if (pair.first < 0 || pair.first >= num_bodies || pair.second < 0 || pair.second >= num_bodies) {
+            throw std::out_of_range("Radiation coupling: body interaction (" + std::to_string(pair.first) + ", " +
+                                    std::to_string(pair.second) + ") out of range for " + std::to_string(num_bodies) +
+                                    " bodies.");
+        }
+        interacting(pair.first, pair.second) = true;
+        interacting(pair.second, pair.first) = true;
+    }
+    interacting.diagonal().setConstant(true);
+
+    RadiationCouplingMap map;
+    map.cols.assign(num_dofs, std::vector<int>());
+    map.num_kernels     = num_dofs * num_dofs;
+    map.num_body_blocks = num_bodies * num_bodies;
+
+    const double max_norm  = norms.maxCoeff();
+    const double threshold = tolerance * max_norm;
+    Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> block_kept;
+    block_kept.setConstant(num_bodies, num_bodies, false);
+    for (int row = 0; row < num_dofs; row++) {
+        for (int col = 0; col < num_dofs; col++) {
+            const double norm = norms(row, col);
+            if (!interacting(row / dofs_per_body, col / dofs_per_body)) {
+                map.num_uncoupled += 1;
+            } else if (norm == 0.0) {
+                map.num_zero += 1;
+            } else if (norm <= threshold) {
+                map.num_negligible += 1;
+            } else {
+                map.cols[row].push_back(col);
+                map.num_kept += 1;
+                block_kept(row / dofs_per_body, col / dofs_per_body) = true;
+                continue;
+            }
+            map.max_pruned_norm = std::max(map.max_pruned_norm, max_norm > 0.0 ? norm / max_norm : 0.0);
+        }
+    }
+    map.num_body_blocks_kept = static_cast<int>(block_kept.count());
+    return map;
+}
@@ -0,0 +1,148 @@
+/*********************************************************************
+ * @file  radiation_fft_convolution.cpp
+ *
+ * @brief implementation file for RadiationFFTConvolution.
+ *********************************************************************/
+#include <hydroc/radiation_fft_convolution.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+void RadiationFFTConvolution::Initialize(const Eigen::Ref<const RowMajorMatrix>& kernel,
+                                         int num_dofs,
+                                         double dt,
+                                         int block_size) {
+    if (num_dofs <= 0 || kernel.rows() != num_dofs || kernel.cols() % num_dofs != 0 || dt <= 0.0) {
+        throw std::invalid_argument("RadiationFFTConvolution: kernel size does not match " +
+                                    std::to_string(num_dofs) + " DoFs, or time step is not positive.");
+    }
+    const int size = static_cast<int>(kernel.cols() / num_dofs);
+
+    // power of 2 partitions, about sqrt(size) by default
+    if (block_size <= 0) {
+        block_size = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(size))));
+    }
+    block_size_ = 1;
+    while (block_size_ < block_size) {
+        block_size_ *= 2;
+    }
+    num_dofs_       = num_dofs;
+    num_partitions_ = (size + block_size_ - 1) / block_size_;
+    num_bins_       = block_size_ + 1;
+    dt_             = dt;
+    const int B     = block_size_;
+    const int tails = num_partitions_ - 1;
+
+    fft_.SetFlag(Eigen::FFT<double>::HalfSpectrum);
+
+    // head: first B lags in reverse order, so that they line up with the velocities of the previous B steps
+    head_kernel_.setZero(num_dofs_, num_dofs_ * B);
+    for (int row = 0; row < num_dofs_; row++) {
+        for (int col = 0; col < num_dofs_; col++) {
+            for (int step = 0; step < std::min(B, size); step++) {
+                head_kernel_(row, col * B + B - 1 - step) = kernel(row, col * size + step);
+            }
+        }
+    }
+
+    // tail: spectra of the zero padded partitions
+    tail_spectra_.setZero(num_bins_, num_dofs_ * num_dofs_ * tails);
+    tail_cols_.assign(num_dofs_, std::vector<int>());
+    Eigen::VectorXd partition(2 * B);
+    for (int row = 0; row < num_dofs_; row++) {
+        for (int col = 0; col < num_dofs_; col++) {
+            bool nonzero = false;
+            for (int p = 1; p <= tails; p++) {
+                partition.setZero();
+                const int first = p * B;
+                const int count = std::min(B, size - first);
+                partition.head(count) = kernel.row(row).segment(col * size + first, count).transpose();
+                nonzero               = nonzero || !partition.isZero(0.0);
+                fft_.fwd(tail_spectra_.col(TailColumn(row, col, p)).data(), partition.data(), 2 * B);
+            }
+            if (nonzero) {
+                tail_cols_[row].push_back(col);
+            }
+        }
+    }
+
+    input_.resize(2 * B, num_dofs_);
+    input_spectra_.resize(num_bins_, num_dofs_ * tails);
+    tail_output_.resize(B, num_dofs_);
+    accumulated_.resize(num_bins_);
+    block_output_.resize(2 * B);
+    force_.resize(num_dofs_);
+    Reset();
+}
+
+void RadiationFFTConvolution::Reset() {
+    input_.setZero();
+    input_spectra_.setZero();
+    tail_output_.setZero();
+    force_.setZero();
+    delay_head_  = 0;
+    position_    = 0;
+    num_samples_ = 0;
+}
+
+const Eigen::VectorXd& RadiationFFTConvolution::Advance(double t, const Eigen::Ref<const Eigen::VectorXd>& velocity) {
+    if (velocity.size() != num_dofs_) {
+        throw std::invalid_argument("RadiationFFTConvolution: velocity size " + std::to_string(velocity.size()) +
+                                    " does not match " + std::to_string(num_dofs_) + " DoFs.");
+    }
+    if (num_samples_ > 0 && std::abs(t - time_ - dt_) > 1e-6 * dt_) {
+        throw std::runtime_error("RadiationFFTConvolution: requires a fixed time step of " + std::to_string(dt_) +
+                                 ", got " + std::to_string(t) + " after " + std::to_string(time_) + ".");
+    }
+    num_samples_ += 1;
+    time_ = t;
+
+    const int B                  = block_size_;
+    input_.row(B + position_)    = velocity.transpose();
+    force_                       = tail_output_.row(position_).transpose();
+    for (int col = 0; col < num_dofs_; col++) {
+        force_.noalias() += head_kernel_.middleCols(col * B, B) * input_.col(col).segment(position_ + 1, B);
+    }
+
+    position_ += 1;
+    if (position_ == B) {
+        ProcessBlock();
+        position_ = 0;
+    }
+    return force_;
+}
+
+void RadiationFFTConvolution::ProcessBlock() {
+    const int B     = block_size_;
+    const int tails = num_partitions_ - 1;
+
+    if (tails > 0) {
+        // spectra of the previous and the completed block, newest first in the delay line
+        delay_head_ = (delay_head_ + tails - 1) % tails;
+        for (int col = 0; col < num_dofs_; col++) {
+            fft_.fwd(input_spectra_.col(DelayColumn(col, 0)).data(), input_.col(col).data(), 2 * B);
+        }
+
+        // tail partition p acts on the block p blocks before the next one, keep the last B samples (overlap-save)
+        for (int row = 0; row < num_dofs_; row++) {
+            if (tail_cols_[row].empty()) {
+                tail_output_.col(row).setZero();
+                continue;
+            }
+            accumulated_.setZero();
+            for (int col : tail_cols_[row]) {
+                for (int p = 1; p <= tails; p++) {
+                    accumulated_ += tail_spectra_.col(TailColumn(row, col, p))
+                                        .cwiseProduct(input_spectra_.col(DelayColumn(col, p - 1)));
+                }
+            }
+            fft_.inv(block_output_.data(), accumulated_.data(), 2 * B);
+            tail_output_.col(row) = block_output_.tail(B);
+        }
+    }
+
+    // the completed block becomes the previous block
+    input_.topRows(B) = input_.bottomRows(B);
+}
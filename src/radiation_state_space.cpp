@@ -0,0 +1,118 @@
+/*********************************************************************
+ * @file  radiation_state_space.cpp
+ *
+ * @brief implementation file for RadiationStateSpace.
+ *********************************************************************/
+#include <hydroc/radiation_state_space.h>
+
+#include <unsupported/Eigen/MatrixFunctions>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+void RadiationStateSpace::Clear(int num_dofs) {
+    kernels_.clear();
+    states_.resize(0);
+    scratch_.resize(0);
+    velocity_.setZero(num_dofs);
+    force_.setZero(num_dofs);
+    step_    = 0.0;
+    started_ = false;
+}
+
+void RadiationStateSpace::AddKernel(int row,
+                                    int col,
+                                    const Eigen::Ref<const Eigen::MatrixXd>& A,
+                                    const Eigen::Ref<const Eigen::VectorXd>& B,
+                                    const Eigen::Ref<const Eigen::RowVectorXd>& C,
+                                    double D) {
+    const int num_dofs = static_cast<int>(force_.size());
+    if (row < 0 || row >= num_dofs || col < 0 || col >= num_dofs) {
+        throw std::out_of_range("RadiationStateSpace: kernel (" + std::to_string(row) + ", " + std::to_string(col) +
+                                ") out of range for " + std::to_string(num_dofs) + " DoFs.");
+    }
+    const int order = static_cast<int>(A.rows());
+    if (A.cols() != order || B.size() != order || C.size() != order) {
+        throw std::invalid_argument("RadiationStateSpace: inconsistent realization sizes for kernel (" +
+                                    std::to_string(row) + ", " + std::to_string(col) + ").");
+    }
+
+    Kernel kernel;
+    kernel.row    = row;
+    kernel.col    = col;
+    kernel.offset = static_cast<int>(states_.size());
+    kernel.A      = A;
+    kernel.B      = B;
+    kernel.C      = C;
+    kernel.D      = D;
+    kernels_.push_back(kernel);
+
+    states_.setZero(states_.size() + order);
+    scratch_.setZero(std::max<Eigen::Index>(scratch_.size(), order));
+    step_    = 0.0;
+    started_ = false;
+}
+
+void RadiationStateSpace::Reset() {
+    states_.setZero();
+    velocity_.setZero();
+    force_.setZero();
+    started_ = false;
+}
+
+const Eigen::VectorXd& RadiationStateSpace::Advance(double t, const Eigen::Ref<const Eigen::VectorXd>& velocity) {
+    if (velocity.size() != velocity_.size()) {
+        throw std::invalid_argument("RadiationStateSpace: velocity size " + std::to_string(velocity.size()) +
+                                    " does not match " + std::to_string(velocity_.size()) + " DoFs.");
+    }
+
+    if (started_) {
+        const double h = t - time_;
+        if (h <= 0.0) {
+            throw std::runtime_error("RadiationStateSpace: time must increase between steps, got " +
+                                     std::to_string(t) + " after " + std::to_string(time_) + ".");
+        }
+        if (std::abs(h - step_) > 1e-12 * h) {
+            Discretize(h);
+        }
+
+        for (auto& kernel : kernels_) {
+            const int order = static_cast<int>(kernel.A.rows());
+            auto x          = states_.segment(kernel.offset, order);
+            auto x_old      = scratch_.head(order);
+            x_old           = x;
+            x.noalias()     = kernel.Ad * x_old;
+            x += kernel.Bd0 * velocity_[kernel.col] + kernel.Bd1 * velocity[kernel.col];
+        }
+    }
+    started_  = true;
+    time_     = t;
+    velocity_ = velocity;
+
+    force_.setZero();
+    for (const auto& kernel : kernels_) {
+        const int order = static_cast<int>(kernel.A.rows());
+        force_[kernel.row] += kernel.C.dot(states_.segment(kernel.offset, order)) + kernel.D * velocity_[kernel.col];
+    }
+    return force_;
+}
+
+void RadiationStateSpace::Discretize(double h) {
+    for (auto& kernel : kernels_) {
+        const int order = static_cast<int>(kernel.A.rows());
+
+        // exp of the system augmented with the velocity and its change over the step (first order hold)
+        Eigen::MatrixXd augmented             = Eigen::MatrixXd::Zero(order + 2, order + 2);
+        augmented.topLeftCorner(order, order) = kernel.A * h;
+        augmented.block(0, order, order, 1)   = kernel.B * h;
+        augmented(order, order + 1)           = 1.0;
+        const Eigen::MatrixXd transition      = augmented.exp();
+
+        kernel.Ad  = transition.topLeftCorner(order, order);
+        kernel.Bd1 = transition.block(0, order + 1, order, 1);
+        kernel.Bd0 = transition.block(0, order, order, 1) - kernel.Bd1;
+    }
+    step_ = h;
+}
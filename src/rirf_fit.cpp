@@ -0,0 +1,97 @@
+/*********************************************************************
+ * @file  rirf_fit.cpp
+ *
+ * @brief implementation file for the identification of state space \
+ * models from sampled RIRF kernels.
+ *********************************************************************/
+#include <hydroc/rirf_fit.h>
+
+#include <Eigen/SVD>
+#include <unsupported/Eigen/MatrixFunctions>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+RIRFKernelFit FitRIRFKernel(const Eigen::Ref<const Eigen::VectorXd>& samples,
+                            double dt,
+                            double tolerance,
+                            int max_order,
+                            double scale) {
+    if (dt <= 0.0 || max_order < 1) {
+        throw std::invalid_argument("FitRIRFKernel: time step and maximum order must be positive.");
+    }
+
+    RIRFKernelFit best;
+    const int size         = static_cast<int>(samples.size());
+    const double norm      = samples.norm();
+    const double reference = std::max(norm, scale);
+    if (norm == 0.0) {
+        return best;
+    }
+
+    // error of the zero model
+    best.error = norm / reference;
+    if (size < 3 || best.error <= tolerance) {
+        return best;
+    }
+
+    // Hankel matrix of the samples, with few rows so that the SVD stays cheap for long kernels
+    const int rows = std::clamp(10 * max_order, 2, size / 2);
+    const int cols = size - rows + 1;
+    Eigen::MatrixXd hankel(rows, cols);
+    for (int j = 0; j < cols; j++) {
+        hankel.col(j) = samples.segment(j, rows);
+    }
+    Eigen::BDCSVD<Eigen::MatrixXd> svd(hankel, Eigen::ComputeThinU | Eigen::ComputeThinV);
+    const Eigen::VectorXd sqrt_sv = svd.singularValues().cwiseSqrt();
+
+    const int orders = std::min<int>(max_order, rows - 1);
+    for (int order = 1; order <= orders; order++) {
+        if (svd.singularValues()[order - 1] <= std::numeric_limits<double>::epsilon() * svd.singularValues()[0]) {
+            break;
+        }
+
+        // balanced realization: observability O = U S^1/2, controllability S^1/2 V^T
+        const Eigen::MatrixXd observability = svd.matrixU().leftCols(order) * sqrt_sv.head(order).asDiagonal();
+        const Eigen::MatrixXd Ad =
+            observability.topRows(rows - 1).completeOrthogonalDecomposition().solve(observability.bottomRows(rows - 1));
+        const Eigen::VectorXd B = sqrt_sv.head(order).cwiseProduct(svd.matrixV().row(0).head(order).transpose());
+        const Eigen::RowVectorXd C = observability.row(0);
+
+        // discrete model must be stable
+        if ((Ad.eigenvalues().cwiseAbs().array() >= 1.0).any()) {
+            continue;
+        }
+
+        // continuous model, rejected if the logarithm is not real (e.g. negative real eigenvalues)
+        const Eigen::MatrixXd A = Ad.log() / dt;
+        if (!A.allFinite() || ((A * dt).exp() - Ad).norm() > 1e-8 * std::max(1.0, Ad.norm())) {
+            continue;
+        }
+
+        // error of the impulse response over all samples
+        Eigen::VectorXd x = B;
+        double error2     = 0.0;
+        for (int step = 0; step < size; step++) {
+            const double residual = C.dot(x) - samples[step];
+            error2 += residual * residual;
+            x = Ad * x;
+        }
+        const double error = std::sqrt(error2) / reference;
+
+        if (error < best.error) {
+            best.order = order;
+            best.error = error;
+            best.A     = A;
+            best.B     = B;
+            best.C     = C;
+        }
+        if (error <= tolerance) {
+            break;
+        }
+    }
+
+    return best;
+}
@@ -0,0 +1,62 @@
+/*********************************************************************
+ * @file  time_history_buffer.cpp
+ *
+ * @brief implementation file for TimeHistoryBuffer.
+ *********************************************************************/
+#include <hydroc/time_history_buffer.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+TimeHistoryBuffer::TimeHistoryBuffer(int width, int capacity) {
+    Reset(width, capacity);
+}
+
+void TimeHistoryBuffer::Reset(int width, int capacity) {
+    capacity_ = std::max(capacity, 1);
+    times_.setZero(capacity_);
+    values_.setZero(2 * capacity_, width);
+    head_ = 0;
+    size_ = 0;
+}
+
+void TimeHistoryBuffer::Push(double t, const Eigen::Ref<const Eigen::VectorXd>& values) {
+    if (values.size() != Width()) {
+        throw std::invalid_argument("TimeHistoryBuffer: sample size " + std::to_string(values.size()) +
+                                    " does not match buffer width " + std::to_string(Width()) + ".");
+    }
+    if (size_ == capacity_) {
+        Grow(2 * capacity_);
+    }
+
+    // the newest sample is stored one row before the previous newest sample
+    head_ = (head_ == 0) ? capacity_ - 1 : head_ - 1;
+    times_[head_]                  = t;
+    values_.row(head_)             = values.transpose();
+    values_.row(head_ + capacity_) = values.transpose();
+    size_ += 1;
+}
+
+void TimeHistoryBuffer::PopOldest() {
+    if (size_ > 0) {
+        size_ -= 1;
+    }
+}
+
+void TimeHistoryBuffer::Grow(int capacity) {
+    Eigen::VectorXd times(capacity);
+    Eigen::MatrixXd values(2 * capacity, values_.cols());
+
+    // store samples in logical order starting from row 0
+    for (int i = 0; i < size_; i++) {
+        times[i]                 = times_[Physical(i)];
+        values.row(i)            = values_.row(Physical(i));
+        values.row(i + capacity) = values.row(i);
+    }
+
+    times_.swap(times);
+    values_.swap(values);
+    capacity_ = capacity;
+    head_     = 0;
+}
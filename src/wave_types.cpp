@@ -3,17 +3,61 @@
  *
  * @brief implementation file for Wavebase and classes inheriting from WaveBase.
  *********************************************************************/
+#include <hydroc/binary_cache.h>
+#include <hydroc/harmonic_synthesis.h>
 #include <hydroc/helper.h>
 #include <hydroc/wave_types.h>
 #include <unsupported/Eigen/Splines>
 
-Eigen::VectorXd NoWave::GetForceAtTime(double t) {
-    unsigned int dof = num_bodies_ * 6;
-    Eigen::VectorXd f(dof);
-    for (int i = 0; i < dof; i++) {
-        f[i] = 0.0;
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <exception>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+namespace {
+void CheckForceSize(Eigen::Index rows, Eigen::Index cols, unsigned int num_bodies, Eigen::Index num_times) {
+    if (rows != 6 * static_cast<Eigen::Index>(num_bodies) || cols != num_times) {
+        throw std::invalid_argument("Wave force buffer is " + std::to_string(rows) + " x " + std::to_string(cols) +
+                                    ", expected " + std::to_string(6 * num_bodies) + " x " +
+                                    std::to_string(num_times) + ".");
+    }
+}
+}  // namespace
+
+void WaveBase::GetForceAtTime(double t, Eigen::Ref<Eigen::VectorXd> force) {
+    const Eigen::VectorXd f = GetForceAtTime(t);
+    if (f.size() != force.size()) {
+        throw std::invalid_argument("Wave force buffer has size " + std::to_string(force.size()) + ", expected " +
+                                    std::to_string(f.size()) + ".");
+    }
+    force = f;
+}
+
+void WaveBase::GetForceAtTimes(const Eigen::Ref<const Eigen::VectorXd>& times, Eigen::Ref<Eigen::MatrixXd> forces) {
+    if (forces.cols() != times.size()) {
+        throw std::invalid_argument("Wave force buffer has " + std::to_string(forces.cols()) + " columns for " +
+                                    std::to_string(times.size()) + " times.");
+    }
+    for (Eigen::Index k = 0; k < times.size(); k++) {
+        GetForceAtTime(times[k], forces.col(k));
     }
-    return f;
+}
+
+Eigen::VectorXd NoWave::GetForceAtTime(double t) {
+    return Eigen::VectorXd::Zero(num_bodies_ * 6);
+}
+
+void NoWave::GetForceAtTime(double t, Eigen::Ref<Eigen::VectorXd> force) {
+    CheckForceSize(force.size(), 1, num_bodies_, 1);
+    force.setZero();
+}
+
+void NoWave::GetForceAtTimes(const Eigen::Ref<const Eigen::VectorXd>& times, Eigen::Ref<Eigen::MatrixXd> forces) {
+    CheckForceSize(forces.rows(), forces.cols(), num_bodies_, times.size());
+    forces.setZero();
 }
 
 RegularWave::RegularWave() {
@@ -43,22 +87,46 @@ void RegularWave::Initialize() {
     }
 }
 
-void RegularWave::AddH5Data(std::vector<HydroData::RegularWaveInfo>& reg_h5_data) {
+HydroDataRequirements RegularWave::GetHydroDataRequirements() const {
+    HydroDataRequirements requirements;
+    requirements.regular_excitation = true;
+    return requirements;
+}
+
+void RegularWave::AddH5Data(const std::vector<HydroData::RegularWaveInfo>& reg_h5_data) {
     wave_info_ = reg_h5_data;
 }
 
 Eigen::VectorXd RegularWave::GetForceAtTime(double t) {
-    unsigned int dof = num_bodies_ * 6;
-    Eigen::VectorXd f(dof);
-    // initialize the force here:
+    Eigen::VectorXd f(num_bodies_ * 6);
+    GetForceAtTime(t, f);
+    return f;
+}
+
+void RegularWave::GetForceAtTime(double t, Eigen::Ref<Eigen::VectorXd> force) {
+    CheckForceSize(force.size(), 1, num_bodies_, 1);
     for (int b = 0; b < num_bodies_; b++) {
         int body_offset = 6 * b;
         for (int rowEx = 0; rowEx < 6; rowEx++) {
-            f[body_offset + rowEx] = excitation_force_mag_[body_offset + rowEx] * regular_wave_amplitude_ *
-                                     cos(regular_wave_omega_ * t + excitation_force_phase_[rowEx]);
+            force[body_offset + rowEx] = excitation_force_mag_[body_offset + rowEx] * regular_wave_amplitude_ *
+                                         cos(regular_wave_omega_ * t + excitation_force_phase_[rowEx]);
+        }
+    }
+}
+
+void RegularWave::GetForceAtTimes(const Eigen::Ref<const Eigen::VectorXd>& times,
+                                  Eigen::Ref<Eigen::MatrixXd> forces) {
+    CheckForceSize(forces.rows(), forces.cols(), num_bodies_, times.size());
+    // forces(i, k) = mag_i A cos(omega t_k + phase_i), one cosine per time and dof
+    for (Eigen::Index k = 0; k < times.size(); k++) {
+        for (int b = 0; b < num_bodies_; b++) {
+            int body_offset = 6 * b;
+            for (int rowEx = 0; rowEx < 6; rowEx++) {
+                forces(body_offset + rowEx, k) = excitation_force_mag_[body_offset + rowEx] * regular_wave_amplitude_ *
+                                                 cos(regular_wave_omega_ * times[k] + excitation_force_phase_[rowEx]);
+            }
         }
     }
-    return f;
 }
 
 double RegularWave::GetOmegaDelta() const {
@@ -118,12 +186,34 @@ std::vector<double> ComputeWaveNumbers(const std::vector<double>& omegas,
     return wave_numbers;
 }
 
+// amplitudes sqrt(2 S df) of the spectral components
+std::vector<double> ComputeComponentAmplitudes(const Eigen::VectorXd& freqs_hz,
+                                               const Eigen::VectorXd& spectral_densities) {
+    double delta_f = freqs_hz(Eigen::last) / freqs_hz.size();
+
+    std::vector<double> sqrt_A(spectral_densities.size());
+    for (size_t i = 0; i < spectral_densities.size(); ++i) {
+        sqrt_A[i] = std::sqrt(2 * spectral_densities[i] * delta_f);
+    }
+    return sqrt_A;
+}
+
+// random phases of the spectral components, reproducible for a given seed
+std::vector<double> ComputeComponentPhases(size_t num_components, int seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> dist(0.0, 2 * M_PI);
+    std::vector<double> phases(num_components);
+    for (size_t i = 0; i < phases.size(); ++i) {
+        phases[i] = dist(rng);
+    }
+    return phases;
+}
+
 std::vector<double> FreeSurfaceElevation(const Eigen::VectorXd& freqs_hz,
                                          const Eigen::VectorXd& spectral_densities,
                                          const Eigen::VectorXd& time_index,
                                          double water_depth,
                                          int seed) {
-    double delta_f = freqs_hz(Eigen::last) / freqs_hz.size();
     std::vector<double> omegas(freqs_hz.size());
 
     for (size_t i = 0; i < freqs_hz.size(); ++i) {
@@ -132,34 +222,29 @@ std::vector<double> FreeSurfaceElevation(const Eigen::VectorXd& freqs_hz,
 
     std::vector<double> wave_numbers = ComputeWaveNumbers(omegas, water_depth);
 
-    std::vector<double> A(spectral_densities.size());
-    for (size_t i = 0; i < spectral_densities.size(); ++i) {
-        A[i] = 2 * spectral_densities[i] * delta_f;
-    }
+    std::vector<double> sqrt_A = ComputeComponentAmplitudes(freqs_hz, spectral_densities);
 
-    std::vector<double> sqrt_A(A.size());
-    for (size_t i = 0; i < A.size(); ++i) {
-        sqrt_A[i] = std::sqrt(A[i]);
-    }
+    std::vector<double> phases = ComputeComponentPhases(omegas.size(), seed);
 
-    std::vector<std::vector<double>> omegas_t(time_index.size(), std::vector<double>(omegas.size()));
-    for (size_t i = 0; i < time_index.size(); ++i) {
-        for (size_t j = 0; j < omegas.size(); ++j) {
-            omegas_t[i][j] = time_index[i] * omegas[j];
+    // uniformly spaced frequencies and times, the sums of harmonics are evaluated with FFTs
+    if (IsUniformlySpaced(freqs_hz) && IsUniformlySpaced(time_index)) {
+        const int last_omega = omegas.size() - 1;
+        const int last_time  = time_index.size() - 1;
+        const double d_omega = (omegas[last_omega] - omegas[0]) / last_omega;
+        const double dt      = (time_index[last_time] - time_index[0]) / last_time;
+        Eigen::MatrixXcd coefficients(omegas.size(), 1);
+        for (size_t i = 0; i < omegas.size(); ++i) {
+            coefficients(i, 0) = std::polar(sqrt_A[i], phases[i]);
         }
-    }
-
-    std::mt19937 rng(seed);
-    std::uniform_real_distribution<double> dist(0.0, 2 * M_PI);
-    std::vector<double> phases(omegas.size());
-    for (size_t i = 0; i < phases.size(); ++i) {
-        phases[i] = dist(rng);
+        HarmonicSynthesis synthesis(omegas.size(), omegas[0], d_omega, dt);
+        Eigen::VectorXd eta = synthesis.Synthesize(coefficients, time_index[0], time_index.size());
+        return std::vector<double>(eta.data(), eta.data() + eta.size());
     }
 
     std::vector<double> eta(time_index.size(), 0.0);
-    for (size_t i = 0; i < spectral_densities.size(); ++i) {
-        for (size_t j = 0; j < time_index.size(); ++j) {
-            eta[j] += sqrt_A[i] * std::cos(omegas_t[j][i] + phases[i]);
+    for (size_t j = 0; j < time_index.size(); ++j) {
+        for (size_t i = 0; i < spectral_densities.size(); ++i) {
+            eta[j] += sqrt_A[i] * std::cos(time_index[j] * omegas[i] + phases[i]);
         }
     }
 
@@ -235,6 +320,19 @@ IrregularWaves::IrregularWaves(const IrregularWaveParams& params)
     : params_(params) {}
 
 void IrregularWaves::InitializeIRFVectors() {
+    // the frequency domain synthesis does not use the excitation IRF
+    if (params_.excitation_mode_ == ExcitationMode::frequencyDomain) {
+        if (!params_.eta_file_path_.empty() || params_.wave_height_ == 0.0 || params_.wave_period_ == 0.0) {
+            throw std::invalid_argument(
+                "Frequency domain excitation requires a wave spectrum (wave height and period), not an eta file.");
+        }
+        CreateSpectrum();
+        CreateFreeSurfaceElevation();
+        spectrumCreated_ = true;
+        InitializeExcitationTable();
+        return;
+    }
+
     ex_irf_sampled_.resize(params_.num_bodies_);
     ex_irf_time_sampled_.resize(params_.num_bodies_);
     ex_irf_width_sampled_.resize(params_.num_bodies_);
@@ -252,6 +350,12 @@ void IrregularWaves::InitializeIRFVectors() {
     if (params_.simulation_dt_ > 0.0) {
         ResampleIRF(params_.simulation_dt_);
     }
+    irf_time_min_ = ex_irf_time_sampled_[0].minCoeff();
+    irf_time_max_ = ex_irf_time_sampled_[0].maxCoeff();
+    for (unsigned int b = 1; b < params_.num_bodies_; b++) {
+        irf_time_min_ = std::min(irf_time_min_, ex_irf_time_sampled_[b].minCoeff());
+        irf_time_max_ = std::max(irf_time_max_, ex_irf_time_sampled_[b].maxCoeff());
+    }
 
     if (!params_.eta_file_path_.empty()) {
         ReadEtaFromFile();
@@ -261,6 +365,125 @@ void IrregularWaves::InitializeIRFVectors() {
         CreateFreeSurfaceElevation();
         spectrumCreated_ = true;
     }
+
+    InitializeExcitationTable();
+}
+
+void IrregularWaves::InitializeExcitationTable() {
+    excitation_table_.resize(0, 0);
+    const bool frequency_domain = params_.excitation_mode_ == ExcitationMode::frequencyDomain;
+    if (!frequency_domain &&
+        (params_.excitation_mode_ != ExcitationMode::precomputed || params_.simulation_dt_ <= 0.0)) {
+        return;
+    }
+
+    // content addressed cache of the table
+    std::string cache_file;
+    CacheKey key;
+    if (!params_.cache_dir_.empty()) {
+        key        = GetCacheKey();
+        cache_file = (std::filesystem::path(params_.cache_dir_) / ("irregular_waves_" + key.GetHex() + ".bin"))
+                         .lexically_normal()
+                         .generic_string();
+        std::vector<Eigen::MatrixXd> cached;
+        if (ReadCacheFile(cache_file, key.GetValue(), cached) && cached.size() == 2 &&
+            cached[0].rows() == 6 * params_.num_bodies_ && cached[1].size() == 1) {
+            excitation_table_       = std::move(cached[0]);
+            excitation_table_start_ = cached[1](0, 0);
+            std::cout << "Read excitation force from " << cache_file << " (" << excitation_table_.cols()
+                      << " steps)." << std::endl;
+            return;
+        }
+    }
+
+    if (frequency_domain) {
+        SynthesizeExcitation();
+    } else {
+        ConvolveExcitation();
+    }
+    std::cout << (frequency_domain ? "Synthesized" : "Precomputed") << " excitation force from "
+              << excitation_table_start_ << " to "
+              << excitation_table_start_ + (excitation_table_.cols() - 1) * params_.simulation_dt_ << " ("
+              << excitation_table_.cols() << " steps, " << GetExcitationTableMemory() / (1024.0 * 1024.0) << " MB)."
+              << std::endl;
+
+    if (!cache_file.empty()) {
+        WriteCacheFile(cache_file, key.GetValue(),
+                       {excitation_table_, Eigen::MatrixXd::Constant(1, 1, excitation_table_start_)});
+    }
+}
+
+void IrregularWaves::ConvolveExcitation() {
+    const double dt         = params_.simulation_dt_;
+    const int total_dofs    = 6 * params_.num_bodies_;
+    const int num_times     = static_cast<int>(std::floor(params_.simulation_duration_ / dt + 1e-9)) + 1;
+    excitation_table_start_ = 0.0;
+    excitation_table_.resize(total_dofs, num_times);
+
+    // exceptions cannot leave the parallel loop, the first one is rethrown afterwards
+    std::exception_ptr error;
+#pragma omp parallel
+    {
+        // each thread moves forward through its own range of time steps
+        FreeSurfaceElevationWindow window;
+#pragma omp for schedule(static)
+        for (int k = 0; k < num_times; k++) {
+            try {
+                const double time = excitation_table_start_ + k * dt;
+                for (int body = 0; body < params_.num_bodies_; body++) {
+                    for (int dof = 0; dof < 6; dof++) {
+                        excitation_table_(body * 6 + dof, k) = ExcitationConvolution(body, dof, time, window);
+                    }
+                }
+            } catch (...) {
+#pragma omp critical
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+    }
+    if (error) {
+        excitation_table_.resize(0, 0);
+        std::rethrow_exception(error);
+    }
+}
+
+CacheKey IrregularWaves::GetCacheKey() const {
+    CacheKey key;
+    key.Add(std::string("IrregularWaves excitation table"));
+    // tables of the elevation series on the stretched grid are not reused
+    key.Add(std::string("elevation on the simulation grid"));
+
+    // every parameter that changes the table, the eta file by its contents
+    key.AddValue(params_.num_bodies_)
+        .AddValue(params_.simulation_dt_)
+        .AddValue(params_.simulation_duration_)
+        .AddValue(params_.ramp_duration_)
+        .AddValue(params_.wave_height_)
+        .AddValue(params_.wave_period_)
+        .AddValue(params_.frequency_min_)
+        .AddValue(params_.frequency_max_)
+        .AddValue(params_.nfrequencies_)
+        .AddValue(params_.peak_enhancement_factor_)
+        .AddValue(params_.is_normalized_)
+        .AddValue(params_.seed_)
+        .AddValue(params_.excitation_mode_);
+    key.AddValue(!params_.eta_file_path_.empty());
+    if (!params_.eta_file_path_.empty()) {
+        key.AddFile(params_.eta_file_path_);
+    }
+
+    // the h5 data used by the table
+    key.AddValue(sim_data_.rho).AddValue(sim_data_.g).AddValue(sim_data_.water_depth);
+    for (const auto& info : wave_info_) {
+        if (params_.excitation_mode_ == ExcitationMode::frequencyDomain) {
+            key.Add(info.freq_list).Add(info.excitation_re_matrix).Add(info.excitation_im_matrix);
+        } else {
+            key.Add(info.excitation_irf_time).Add(info.excitation_irf_matrix);
+        }
+    }
+    return key;
 }
 
 std::vector<double> IrregularWaves::GetSpectrum() {
@@ -272,64 +495,158 @@ std::vector<double> IrregularWaves::GetSpectrum() {
 }
 
 std::vector<double> IrregularWaves::GetFreeSurfaceElevation() {
-    return free_surface_elevation_sampled_;
+    if (!params_.eta_file_path_.empty()) {
+        std::vector<double> eta(eta_record_.GetSize());
+        for (size_t i = 0; i < eta.size(); ++i) {
+            eta[i] = eta_record_.GetElevation(i);
+        }
+        return eta;
+    }
+    std::vector<double> eta(static_cast<int>(params_.simulation_duration_ / params_.simulation_dt_) + 1);
+    free_surface_generator_.Generate(0, eta.size(), eta.data());
+    return eta;
 }
 
 std::vector<double> IrregularWaves::GetEtaTimeData() {
-    return time_data_;
+    std::vector<double> times(eta_record_.GetSize());
+    for (size_t i = 0; i < times.size(); ++i) {
+        times[i] = eta_record_.GetTime(i);
+    }
+    return times;
 }
 
 void IrregularWaves::ReadEtaFromFile() {
     std::cout << "Reading eta file " << params_.eta_file_path_ << "." << std::endl;
-    std::ifstream file(params_.eta_file_path_);
-    if (!file) {
-        throw std::runtime_error("Unable to open file at: " + params_.eta_file_path_ + ".");
-    }
-
-    std::string line;
-    double time, eta;
-
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        char delimiter;
-        if (!(ss >> time >> delimiter >> eta) || delimiter != ':') {
-            throw std::runtime_error("Could not parse line: " + line + ".");
-        }
-        time_data_.push_back(time);
-        free_surface_elevation_sampled_.push_back(eta);
-    }
-    std::cout << "Finished reading eta file." << std::endl;
+    eta_record_ = EtaRecord::Read(params_.eta_file_path_);
+    std::cout << "Finished reading eta file (" << eta_record_.GetSize() << " samples"
+              << (eta_record_.IsUniform() ? ", uniform time step" : "")
+              << (eta_record_.IsMapped() ? ", memory mapped" : "") << ")." << std::endl;
 }
 
 Eigen::MatrixXd IrregularWaves::GetExcitationIRF(int b) const {
     return wave_info_[b].excitation_irf_matrix;
 }
 
-void IrregularWaves::AddH5Data(std::vector<HydroData::IrregularWaveInfo>& irreg_h5_data,
-                               HydroData::SimulationParameters& sim_data) {
+HydroDataRequirements IrregularWaves::GetHydroDataRequirements() const {
+    HydroDataRequirements requirements;
+    if (params_.excitation_mode_ == ExcitationMode::frequencyDomain) {
+        requirements.irregular_excitation = true;
+    } else {
+        requirements.excitation_irf = true;
+    }
+    return requirements;
+}
+
+void IrregularWaves::AddH5Data(const std::vector<HydroData::IrregularWaveInfo>& irreg_h5_data,
+                               const HydroData::SimulationParameters& sim_data) {
     wave_info_ = irreg_h5_data;
+    sim_data_  = sim_data;
 
     InitializeIRFVectors();
 }
 
+void IrregularWaves::SynthesizeExcitation() {
+    if (params_.simulation_dt_ <= 0.0) {
+        throw std::invalid_argument("Frequency domain excitation requires a positive simulation time step.");
+    }
+    const int num_frequencies = spectrum_frequencies_.size();
+    const int total_dofs      = 6 * params_.num_bodies_;
+    const double omega_0      = 2 * M_PI * spectrum_frequencies_[0];
+    const double d_omega =
+        num_frequencies > 1 ? 2 * M_PI * (spectrum_frequencies_[1] - spectrum_frequencies_[0]) : 0.0;
+
+    // complex amplitude of each spectral component in each force DoF
+    std::vector<double> sqrt_A = ComputeComponentAmplitudes(spectrum_frequencies_, spectral_densities_);
+    std::vector<double> phases = ComputeComponentPhases(num_frequencies, params_.seed_);
+    Eigen::MatrixXcd coefficients(num_frequencies, total_dofs);
+    for (int body = 0; body < params_.num_bodies_; body++) {
+        const auto& omegas = wave_info_[body].freq_list;
+        const auto& re     = wave_info_[body].excitation_re_matrix;
+        const auto& im     = wave_info_[body].excitation_im_matrix;
+        const int last     = omegas.size() - 1;
+        if (last < 1 || re.cols() != omegas.size() || im.cols() != omegas.size()) {
+            throw std::runtime_error("Frequency domain excitation: missing excitation coefficients in the h5 file.");
+        }
+
+        // linear interpolation of the coefficients, end values outside of the h5 frequencies
+        int idx = 0;
+        for (int k = 0; k < num_frequencies; k++) {
+            const double omega = std::clamp(omega_0 + k * d_omega, omegas[0], omegas[last]);
+            while (idx < last - 1 && omegas[idx + 1] < omega) {
+                idx += 1;
+            }
+            const double w2                      = (omega - omegas[idx]) / (omegas[idx + 1] - omegas[idx]);
+            const std::complex<double> component = std::polar(sqrt_A[k], phases[k]);
+            for (int dof = 0; dof < 6; dof++) {
+                std::complex<double> excitation((1.0 - w2) * re(dof, idx) + w2 * re(dof, idx + 1),
+                                                (1.0 - w2) * im(dof, idx) + w2 * im(dof, idx + 1));
+                coefficients(k, body * 6 + dof) = component * excitation;
+            }
+        }
+    }
+
+    const double dt         = params_.simulation_dt_;
+    const int num_times     = static_cast<int>(std::floor(params_.simulation_duration_ / dt + 1e-9)) + 1;
+    excitation_table_start_ = 0.0;
+    HarmonicSynthesis synthesis(num_frequencies, omega_0, d_omega, dt);
+    excitation_table_ = synthesis.Synthesize(coefficients, excitation_table_start_, num_times).transpose();
+
+    if (params_.ramp_duration_ > 0.0) {
+        for (int k = 0; k < num_times; k++) {
+            excitation_table_.col(k) *= std::min(k * dt / params_.ramp_duration_, 1.0);
+        }
+    }
+}
+
+bool IrregularWaves::InterpolateExcitationTable(double t, Eigen::Ref<Eigen::VectorXd> force) const {
+    // precomputed force, linear interpolation between the neighbouring time steps
+    const int num_times = static_cast<int>(excitation_table_.cols());
+    if (num_times < 2) {
+        return false;
+    }
+    const double position = (t - excitation_table_start_) / params_.simulation_dt_;
+    if (!(position >= 0.0 && position <= num_times - 1)) {
+        return false;
+    }
+    const int idx   = std::min(static_cast<int>(position), num_times - 2);
+    const double w2 = position - idx;
+    force           = (1.0 - w2) * excitation_table_.col(idx) + w2 * excitation_table_.col(idx + 1);
+    return true;
+}
+
 Eigen::VectorXd IrregularWaves::GetForceAtTime(double t) {
-    unsigned int total_dofs = params_.num_bodies_ * 6;
-    Eigen::VectorXd f(total_dofs);
-    for (int i = 0; i < total_dofs; i++) {
-        f[i] = 0.0;
+    Eigen::VectorXd f(params_.num_bodies_ * 6);
+    GetForceAtTime(t, f);
+    return f;
+}
+
+void IrregularWaves::GetForceAtTime(double t, Eigen::Ref<Eigen::VectorXd> force) {
+    CheckForceSize(force.size(), 1, params_.num_bodies_, 1);
+    if (InterpolateExcitationTable(t, force)) {
+        return;
+    }
+    if (params_.excitation_mode_ == ExcitationMode::frequencyDomain) {
+        throw std::runtime_error("Frequency domain excitation: time " + std::to_string(t) +
+                                 " is out of the synthesized simulation duration.");
     }
 
     for (int body = 0; body < params_.num_bodies_; body++) {
         // Loop through the DOFs
         for (int dof = 0; dof < 6; ++dof) {
             // Compute the convolution for the current DOF
-            double f_dof          = ExcitationConvolution(body, dof, t);
-            unsigned int b_offset = body * 6;
-            f[b_offset + dof]     = f_dof;
+            force[body * 6 + dof] = ExcitationConvolution(body, dof, t, free_surface_window_);
         }
     }
+}
 
-    return f;
+void IrregularWaves::GetForceAtTimes(const Eigen::Ref<const Eigen::VectorXd>& times,
+                                     Eigen::Ref<Eigen::MatrixXd> forces) {
+    CheckForceSize(forces.rows(), forces.cols(), params_.num_bodies_, times.size());
+    for (Eigen::Index k = 0; k < times.size(); k++) {
+        if (!InterpolateExcitationTable(times[k], forces.col(k))) {
+            GetForceAtTime(times[k], forces.col(k));
+        }
+    }
 }
 
 void IrregularWaves::ResampleIRF(double dt) {
@@ -416,6 +733,10 @@ void IrregularWaves::CreateSpectrum() {
     spectral_densities_ =
         JONSWAPSpectrumHz(spectrum_frequencies_,params_. wave_height_,params_. wave_period_, params_.peak_enhancement_factor_, params_.is_normalized_);
 
+    if (!params_.write_wave_files_) {
+        return;
+    }
+
     // Open a file stream for writing
     std::ofstream outputFile("spectral_densities.txt");
 
@@ -473,63 +794,41 @@ Eigen::VectorXd JONSWAPSpectrumHz(Eigen::VectorXd& f, double Hs, double Tp, doub
 }
 
 void IrregularWaves::CreateFreeSurfaceElevation() {
-    // Create a time index vector
-    // UpdateNumTimesteps();
-    int num_timesteps = static_cast<int>(params_.simulation_duration_ / params_.simulation_dt_) + 1;
-
-    double t_irf_min = 0.0;
-    double t_irf_max = 0.0;
-    for (auto ii = 0; ii < ex_irf_time_sampled_.size(); ii++) {
-        if (ex_irf_time_sampled_[ii][0] < t_irf_min) {
-            t_irf_min = ex_irf_time_sampled_[ii][0];
-        }
-        if (ex_irf_time_sampled_[ii][0] > t_irf_max) {
-            t_irf_max = ex_irf_time_sampled_[ii][0];
-        }
-        if (ex_irf_time_sampled_[ii][ex_irf_time_sampled_[ii].size() - 1] > t_irf_max) {
-            t_irf_max = ex_irf_time_sampled_[ii][ex_irf_time_sampled_[ii].size() - 1];
-        }
-        if (ex_irf_time_sampled_[ii][ex_irf_time_sampled_[ii].size() - 1] < t_irf_min) {
-            t_irf_min = ex_irf_time_sampled_[ii][ex_irf_time_sampled_[ii].size() - 1];
-        }
+    if (params_.simulation_dt_ <= 0.0) {
+        throw std::invalid_argument("Irregular waves: the free surface elevation requires a positive time step.");
     }
 
-    auto time_array = Eigen::VectorXd::LinSpaced(num_timesteps, 0, params_.simulation_duration_ + 2 * (t_irf_max - t_irf_min));
+    // the elevation is generated on demand on the simulation time grid, with the same ramp at every time
+    std::vector<double> omegas(spectrum_frequencies_.size());
+    for (size_t i = 0; i < omegas.size(); ++i) {
+        omegas[i] = 2 * M_PI * spectrum_frequencies_[i];
+    }
+    free_surface_generator_ = FreeSurfaceElevationGenerator(
+        ComputeComponentAmplitudes(spectrum_frequencies_, spectral_densities_), omegas,
+        ComputeComponentPhases(omegas.size(), params_.seed_), params_.simulation_dt_, params_.ramp_duration_);
+    free_surface_window_.Clear();
 
-    // Save time array as a std::vector
-    free_surface_time_sampled_.resize(time_array.size());
-    Eigen::VectorXd::Map(&free_surface_time_sampled_[0], time_array.size()) = time_array;
-    for (int ii = 0; ii < free_surface_time_sampled_.size(); ii++) {
-        free_surface_time_sampled_[ii] += -t_irf_max;
+    if (!params_.write_wave_files_) {
+        return;
     }
 
-    std::cout << "Precalculating free surface elevation from " + std::to_string(free_surface_time_sampled_.front()) +
-                     " to " + std::to_string(free_surface_time_sampled_.back()) + "."
+    std::cout << "Writing free surface elevation from 0 to " + std::to_string(params_.simulation_duration_) + "."
               << std::endl;
 
-    // Calculate the free surface elevation
-    free_surface_elevation_sampled_ =
-        FreeSurfaceElevation(spectrum_frequencies_, spectral_densities_, time_array, sim_data_.water_depth, params_.seed_);
-
-    // Apply ramp if ramp_duration is greater than 0
-    if (params_.ramp_duration_ > 0.0) {
-        // UpdateRampTimesteps();
-        int ramp_timesteps   = static_cast<int>(params_.ramp_duration_ / params_.simulation_dt_) + 1;
-        Eigen::VectorXd ramp = Eigen::VectorXd::LinSpaced(ramp_timesteps, 0.0, 1.0);
-
-        for (size_t i = 0; i < ramp.size(); ++i) {
-            free_surface_elevation_sampled_[i] *= ramp[i];
-        }
-    }
-
     // Open a file stream for writing
     std::ofstream eta_output("eta.txt");
 
     // Check if the file stream is open
     if (eta_output.is_open()) {
-        // Write the spectral densities and their corresponding frequencies to the file
-        for (size_t i = 0; i < free_surface_elevation_sampled_.size(); ++i) {
-            eta_output << free_surface_time_sampled_[i] << " : " << free_surface_elevation_sampled_[i] << std::endl;
+        // Write the free surface elevation chunk by chunk
+        const int num_timesteps = static_cast<int>(params_.simulation_duration_ / params_.simulation_dt_) + 1;
+        std::vector<double> eta(free_surface_generator_.GetChunkSize());
+        for (int first = 0; first < num_timesteps; first += eta.size()) {
+            const int count = std::min(static_cast<int>(eta.size()), num_timesteps - first);
+            free_surface_generator_.Generate(first, count, eta.data());
+            for (int i = 0; i < count; ++i) {
+                eta_output << (first + i) * params_.simulation_dt_ << " : " << eta[i] << std::endl;
+            }
         }
         // Close the file stream
         eta_output.close();
@@ -537,74 +836,52 @@ void IrregularWaves::CreateFreeSurfaceElevation() {
         std::cerr << "Unable to open file for writing." << std::endl;
     }
 
-    std::cout << "Finished precalculating free surface elevation." << std::endl;
+    std::cout << "Finished writing free surface elevation." << std::endl;
 }
 
-double IrregularWaves::ExcitationConvolution(int body, int dof, double time) {
+double IrregularWaves::ExcitationConvolution(int body,
+                                             int dof,
+                                             double time,
+                                             FreeSurfaceElevationWindow& window) const {
     double f_ex           = 0.0;
     auto& irf_time_array  = ex_irf_time_sampled_[body];
     auto& irf_val_mat     = ex_irf_sampled_[body];
     auto& irf_width_array = ex_irf_width_sampled_[body];
 
-    // asumptions: irf_time_array in ascending order, free_surface_time_sampled_ in ascending order
-    // get initial index
-    auto tmin    = free_surface_time_sampled_.front();
-    auto tmax    = free_surface_time_sampled_.back();
-    double t_tau = time - irf_time_array[0];
-    int idx      = 0;
-    if (t_tau <= tmin) {
-        idx = 0;
-    } else if (t_tau >= tmax) {
-        idx = free_surface_time_sampled_.size() - 2;
-    } else {
-        idx = get_lower_index(t_tau, free_surface_time_sampled_);
-    }
-
-    // loop for all irf time values
-    for (size_t j = 0; j < irf_time_array.size(); ++j) {
-        double tau   = irf_time_array[j];
-        double t_tau = time - tau;
-        if (tmin <= t_tau && t_tau <= tmax) {
-            // find next index if current lower bound > t_tau
-            while (free_surface_time_sampled_[idx] > t_tau) {
-                idx -= 1;
-            }
-
-            // free surface time values
-            auto t1 = free_surface_time_sampled_[idx];
-            auto t2 = free_surface_time_sampled_[idx + 1];
-
-            // get free surface elevation
-            double eta_val;
-            if (t_tau == t1) {
-                eta_val = free_surface_time_sampled_[idx];
-            } else if (t_tau == t2) {
-                eta_val = free_surface_time_sampled_[idx + 1];
-            } else if (t_tau > t1 && t_tau < t2) {
-                // linearly interpolate free surface elevation between bounds
-                auto eta1 = free_surface_elevation_sampled_[idx];
-                auto eta2 = free_surface_elevation_sampled_[idx + 1];
-                // weights
-                auto w1 = (t2 - t_tau) / (t2 - t1);
-                auto w2 = 1.0 - w1;
-                // weighted value
-                eta_val = w1 * eta1 + w2 * eta2;
-            } else {
-                throw std::runtime_error("Excitation convolution: wrong tau value " + std::to_string(tau) +
-                                         " not between " + std::to_string(t1) + " and " + std::to_string(t2) + ".");
-            }
+    if (params_.eta_file_path_.empty()) {
+        if (free_surface_generator_.GetTimeStep() <= 0.0) {
+            return 0.0;  // no wave spectrum
+        }
 
-            // add to excitation force
+        // generated samples n dt covering time - tau for the IRF times of all bodies, the same range for every call
+        const double dt   = free_surface_generator_.GetTimeStep();
+        const auto first  = static_cast<std::int64_t>(std::floor((time - irf_time_max_) / dt));
+        const auto last   = static_cast<std::int64_t>(std::floor((time - irf_time_min_) / dt)) + 1;
+        const int max_idx = static_cast<int>(last - first) - 1;
+        const double* eta = window.GetSamples(free_surface_generator_, first, last);
+        for (int j = 0; j < irf_time_array.size(); ++j) {
+            const double position = (time - irf_time_array[j]) / dt - first;
+            const int idx         = std::clamp(static_cast<int>(position), 0, max_idx);
+            const double w2       = position - idx;
+            const double eta_val  = (1.0 - w2) * eta[idx] + w2 * eta[idx + 1];
             f_ex += irf_val_mat(dof, j) * eta_val * irf_width_array[j];
-
-        } else {
-            // throw error if trying to compute convolution after the maximum precomputed free elevation time
-            throw std::runtime_error(
-                "Excitation convolution: trying to find free surface elevation at a time out of bounds from the "
-                "precomputed free surface elevation (" +
-                std::to_string(t_tau) + "not in [" + std::to_string(tmin) + ", " + std::to_string(tmax) +
-                "]). Excitation force ignored at this time step.");
         }
+        return f_ex;
+    }
+
+    // eta file: the elevation counts as zero before and after the record only within the IRF span, the time itself
+    // must be within the record. One time step past its end is accepted, for the update of the loads at the end of the
+    // last step of a simulation as long as the record
+    const double record_start = eta_record_.GetTime(0);
+    const double record_end   = eta_record_.GetTime(eta_record_.GetSize() - 1);
+    const double tolerance    = 1e-6 * params_.simulation_dt_;
+    if (!(time >= record_start - tolerance && time <= record_end + params_.simulation_dt_ + tolerance)) {
+        throw std::runtime_error("Eta file " + params_.eta_file_path_ + ": time " + std::to_string(time) +
+                                 " is outside of the record, from " + std::to_string(record_start) + " to " +
+                                 std::to_string(record_end) + ".");
+    }
+    for (int j = 0; j < irf_time_array.size(); ++j) {
+        f_ex += irf_val_mat(dof, j) * eta_record_.GetElevationAt(time - irf_time_array[j]) * irf_width_array[j];
     }
 
     return f_ex;
@@ -615,7 +892,7 @@ void IrregularWaves::SetUpWaveMesh(std::string filename) {
     int num_timesteps          = static_cast<int>(params_.simulation_duration_ / params_.simulation_dt_) + 1;
     Eigen::VectorXd time_index = Eigen::VectorXd::LinSpaced(num_timesteps, 0, params_.simulation_duration_);
     std::vector<std::array<double, 3>> free_surface_3d_pts =
-        CreateFreeSurface3DPts(free_surface_elevation_sampled_, time_index);
+        CreateFreeSurface3DPts(GetFreeSurfaceElevation(), time_index);
     std::vector<std::array<size_t, 3>> free_surface_triangles = CreateFreeSurfaceTriangles(time_index.size());
 
     WriteFreeSurfaceMeshObj(free_surface_3d_pts, free_surface_triangles, mesh_file_name_);
@@ -0,0 +1,64 @@
+#include <hydroc/binary_cache.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    // keys depend on every value and on the order
+    Eigen::MatrixXd values = Eigen::MatrixXd::Random(3, 4);
+    const auto key         = CacheKey().AddValue(0.01).Add(values).Add(std::string("sphere")).GetValue();
+    if (key != CacheKey().AddValue(0.01).Add(values).Add(std::string("sphere")).GetValue() ||
+        key == CacheKey().AddValue(0.02).Add(values).Add(std::string("sphere")).GetValue() ||
+        key == CacheKey().Add(values).AddValue(0.01).Add(std::string("sphere")).GetValue() ||
+        key == CacheKey().AddValue(0.01).Add(values.transpose().eval()).Add(std::string("sphere")).GetValue() ||
+        CacheKey().GetHex().size() != 16) {
+        std::cerr << "Wrong cache keys" << std::endl;
+        return 1;
+    }
+
+    const auto dir       = std::filesystem::temp_directory_path() / "hydrochrono_binary_cache_t01";
+    const auto file_name = (dir / "entry.bin").generic_string();
+    std::filesystem::remove_all(dir);
+
+    std::vector<Eigen::MatrixXd> matrices;
+    if (ReadCacheFile(file_name, key, matrices)) {
+        std::cerr << "Read a missing cache file" << std::endl;
+        return 1;
+    }
+
+    // round trip, including an empty matrix
+    WriteCacheFile(file_name, key, {values, Eigen::MatrixXd(0, 2), Eigen::MatrixXd::Constant(1, 1, 2.5)});
+    if (!ReadCacheFile(file_name, key, matrices) || matrices.size() != 3 || matrices[0] != values ||
+        matrices[1].rows() != 0 || matrices[1].cols() != 2 || matrices[2](0, 0) != 2.5) {
+        std::cerr << "Wrong cache file round trip" << std::endl;
+        return 1;
+    }
+
+    // another key, and a truncated file, are cache misses that leave the matrices unchanged
+    matrices.clear();
+    if (ReadCacheFile(file_name, key + 1, matrices) || !matrices.empty()) {
+        std::cerr << "Read a cache file with another key" << std::endl;
+        return 1;
+    }
+    std::filesystem::resize_file(file_name, std::filesystem::file_size(file_name) - 8);
+    if (ReadCacheFile(file_name, key, matrices) || !matrices.empty()) {
+        std::cerr << "Read a truncated cache file" << std::endl;
+        return 1;
+    }
+
+    // file contents in the key
+    const auto data_file = (dir / "data.txt").generic_string();
+    std::ofstream(data_file) << "0 : 1.0\n";
+    const auto file_key = CacheKey().AddFile(data_file).GetValue();
+    std::ofstream(data_file) << "0 : 1.5\n";
+    if (file_key == CacheKey().AddFile(data_file).GetValue()) {
+        std::cerr << "File contents not in the cache key" << std::endl;
+        return 1;
+    }
+
+    std::filesystem::remove_all(dir);
+    std::cout << "End" << std::endl;
+    return 0;
+}
@@ -10,6 +10,7 @@
 #include <filesystem>  // C++17
 #include <iostream>
 #include <memory>
+#include <stdexcept>
 #include <vector>
 
 using std::filesystem::absolute;
@@ -57,6 +58,20 @@ int main(int argc, char* argv[]) {
 
     my_loadbodyinertia = chrono_types::make_shared<ChLoadAddedMass>(infos.GetBodyInfos(), loadables, &my_system);
 
+    // instantaneous radiation damping must be 6N x 6N, or empty
+    my_loadbodyinertia->SetRadiationDamping(ChMatrixDynamic<double>::Identity(6 * nBodies, 6 * nBodies));
+    my_loadbodyinertia->SetRadiationDamping(ChMatrixDynamic<double>());
+    bool thrown = false;
+    try {
+        my_loadbodyinertia->SetRadiationDamping(ChMatrixDynamic<double>::Identity(6, 6));
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    if (!thrown) {
+        std::cerr << "Radiation damping of the wrong size accepted" << std::endl;
+        return 1;
+    }
+
     std::cout << "End" << std::endl;
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include <hydroc/chloadhydroforces.h>
+#include <hydroc/helper.h>
+#include <hydroc/hydro_forces.h>
+
+#include <chrono/physics/ChSystemNSC.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>  // C++17
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using std::filesystem::path;
+
+namespace {
+struct HydroModel {
+    ChSystemNSC system;
+    std::vector<std::shared_ptr<ChBody>> bodies;
+    std::unique_ptr<TestHydro> hydro_forces;
+};
+
+// RM3 float and plate, displaced, rotated and moving, at time 1
+void SetUp(HydroModel& model, const std::string& h5fname) {
+    model.system.Set_G_acc(ChVector<>(0.0, 0.0, -9.81));
+    model.system.SetStep(0.01);
+    const double heave[2] = {-0.72, -21.29};
+    for (int b = 0; b < 2; b++) {
+        auto body = chrono_types::make_shared<ChBody>();
+        model.system.Add(body);
+        body->SetNameString("body" + std::to_string(b + 1));
+        body->SetPos(ChVector<>(0.1 * b, 0.2, heave[b] + 0.3));
+        body->SetRot(Q_from_Euler123(ChVector<>(0.05, -0.1 * (b + 1), 0.2)));
+        body->SetPos_dt(ChVector<>(0.5, -0.2, 0.4 * (b + 1)));
+        body->SetWvel_par(ChVector<>(0.03, 0.1, -0.05));
+        model.bodies.push_back(body);
+    }
+    model.hydro_forces = std::make_unique<TestHydro>(model.bodies, h5fname, std::make_shared<NoWave>(2));
+    model.system.SetChTime(1.0);
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+
+    auto h5fname = (DATADIR / "rm3" / "hydroData" / "rm3.h5").lexically_normal().generic_string();
+
+    // reference: the total force read component by component from the body states
+    HydroModel reference;
+    SetUp(reference, h5fname);
+    std::vector<double> expected(12);
+    for (int b = 1; b <= 2; b++) {
+        for (int dof = 0; dof < 6; dof++) {
+            expected[6 * (b - 1) + dof] = reference.hydro_forces->CoordinateFuncForBody(b, dof);
+        }
+    }
+
+    // the same states passed to the load as state vectors
+    HydroModel model;
+    SetUp(model, h5fname);
+    std::vector<std::shared_ptr<ChLoadable>> loadables(model.bodies.begin(), model.bodies.end());
+    ChLoadHydroForces load(model.hydro_forces.get(), loadables);
+    ChState state_x(14, nullptr);
+    ChStateDelta state_w(12, nullptr);
+    for (int b = 0; b < 2; b++) {
+        const auto& body = model.bodies[b];
+        const auto wvel  = body->GetWvel_loc();
+        for (int ii = 0; ii < 3; ii++) {
+            state_x(7 * b + ii)     = body->GetPos()[ii];
+            state_w(6 * b + ii)     = body->GetPos_dt()[ii];
+            state_w(6 * b + ii + 3) = wvel[ii];
+        }
+        for (int ii = 0; ii < 4; ii++) {
+            state_x(7 * b + 3 + ii) = body->GetRot()[ii];
+        }
+    }
+    load.ComputeQ(&state_x, &state_w);
+
+    // forces in the absolute frame, torques in the body frame
+    double max_force = 0.0;
+    double max_error = 0.0;
+    for (int b = 0; b < 2; b++) {
+        const auto& Q     = load.GetQ();
+        const auto torque = model.bodies[b]->GetRot().Rotate(ChVector<>(Q(6 * b + 3), Q(6 * b + 4), Q(6 * b + 5)));
+        for (int ii = 0; ii < 3; ii++) {
+            max_force = std::max({max_force, std::abs(expected[6 * b + ii]), std::abs(expected[6 * b + ii + 3])});
+            max_error = std::max({max_error, std::abs(Q(6 * b + ii) - expected[6 * b + ii]),
+                                  std::abs(torque[ii] - expected[6 * b + ii + 3])});
+        }
+    }
+    if (max_force == 0.0 || max_error > 1e-9 * max_force) {
+        std::cerr << "Hydro force load differs from the component forces by " << max_error << ", max force "
+                  << max_force << std::endl;
+        return 1;
+    }
+
+    std::cout << "End" << std::endl;
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include <hydroc/eta_record.h>
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+bool Throws(const std::string& file_name) {
+    try {
+        EtaRecord::Read(file_name);
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+bool Check(const EtaRecord& record, const std::string& name, bool uniform, bool mapped, double tolerance) {
+    // eta = sin(t), sampled at 0.5 s from t = 1, values at the samples, halfway between and outside
+    const double expected_mid = 0.5 * (std::sin(2.0) + std::sin(2.5));
+    if (record.GetSize() != 20 || record.IsUniform() != uniform || record.IsMapped() != mapped ||
+        std::abs(record.GetTime(3) - 2.5) > 1e-12 || std::abs(record.GetElevationAt(2.5) - std::sin(2.5)) > tolerance ||
+        std::abs(record.GetElevationAt(2.25) - expected_mid) > tolerance || record.GetElevationAt(0.9) != 0.0 ||
+        record.GetElevationAt(10.6) != 0.0 || std::abs(record.GetElevationAt(10.5) - std::sin(10.5)) > tolerance) {
+        std::cerr << "Wrong " << name << " record" << std::endl;
+        return false;
+    }
+    return true;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const auto dir = std::filesystem::temp_directory_path() / "hydrochrono_eta_record_t01";
+    std::filesystem::create_directories(dir);
+    auto file = [&](const std::string& name) { return (dir / name).generic_string(); };
+
+    std::vector<double> values(20);
+    {
+        std::ofstream text(file("uniform.txt"));
+        for (int i = 0; i < 20; i++) {
+            values[i] = std::sin(1.0 + 0.5 * i);
+            text.precision(17);
+            text << 1.0 + 0.5 * i << " : " << values[i] << (i % 2 ? "\r\n" : "\n");
+        }
+        text << "\n";
+    }
+    EtaRecord::WriteBinary(file("double.bin"), 1.0, 0.5, values);
+    EtaRecord::WriteBinary(file("single.bin"), 1.0, 0.5, values, true);
+
+    // non-uniform times: the same samples with one shifted time between 2.5 and 3.0
+    {
+        std::ofstream text(file("nonuniform.txt"));
+        text.precision(17);
+        for (int i = 0; i < 20; i++) {
+            text << (i == 4 ? 2.9 : 1.0 + 0.5 * i) << " : " << (i == 4 ? std::sin(2.9) : values[i]) << "\n";
+        }
+    }
+
+    bool ok = Check(EtaRecord::Read(file("uniform.txt")), "text", true, false, 1e-15) &&
+              Check(EtaRecord::Read(file("double.bin")), "float64", true, true, 1e-15) &&
+              Check(EtaRecord::Read(file("single.bin")), "float32", true, true, 1e-6) &&
+              Check(EtaRecord::Read(file("nonuniform.txt")), "non-uniform", false, false, 1e-15);
+
+    // times not increasing, unparsable lines, too short or damaged files
+    std::ofstream(file("decreasing.txt")) << "0 : 1\n0.5 : 2\n0.4 : 3\n";
+    std::ofstream(file("syntax.txt")) << "0 : 1\n0.5 ; 2\n";
+    std::ofstream(file("short.txt")) << "0 : 1\n";
+    std::filesystem::copy_file(file("double.bin"), file("damaged.bin"));
+    std::filesystem::resize_file(file("damaged.bin"), std::filesystem::file_size(file("double.bin")) - 4);
+    for (const auto& name : {"decreasing.txt", "syntax.txt", "short.txt", "damaged.bin", "missing.txt"}) {
+        if (!Throws(file(name))) {
+            std::cerr << "No error for " << name << std::endl;
+            ok = false;
+        }
+    }
+
+    std::filesystem::remove_all(dir);
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "End" << std::endl;
+    return 0;
+}
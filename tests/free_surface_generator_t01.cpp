@@ -0,0 +1,66 @@
+#include <hydroc/free_surface_generator.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    const int num_components = 25;
+    const double dt          = 0.017;
+    const double ramp        = 3.0;
+    const int chunk_size     = 64;
+
+    std::vector<double> amplitudes(num_components), omegas(num_components), phases(num_components);
+    for (int k = 0; k < num_components; k++) {
+        amplitudes[k] = 1.0 / (1.0 + k);
+        phases[k]     = std::fmod(2.3 * k, 6.28);
+    }
+    auto expected = [&](long long n, double ramp_duration) {
+        const double t = n * dt;
+        double eta     = 0.0;
+        for (int k = 0; k < num_components; k++) {
+            eta += amplitudes[k] * std::cos(omegas[k] * t + phases[k]);
+        }
+        return ramp_duration > 0.0 ? eta * std::clamp(t / ramp_duration, 0.0, 1.0) : eta;
+    };
+
+    // uniformly spaced frequencies (FFT synthesis) and not (phasor recurrence), with and without ramp
+    for (int test = 0; test < 4; test++) {
+        const bool uniform         = test < 2;
+        const double ramp_duration = test % 2 == 0 ? 0.0 : ramp;
+        for (int k = 0; k < num_components; k++) {
+            omegas[k] = uniform ? 0.2 + 0.137 * k : 0.2 + 0.137 * k + 0.001 * k * k;
+        }
+        FreeSurfaceElevationGenerator generator(amplitudes, omegas, phases, dt, ramp_duration, chunk_size);
+
+        // several chunks, before and after t = 0, and far into a long simulation
+        for (long long first : {-150LL, 0LL, 37LL, 50000000LL}) {
+            std::vector<double> eta(300);
+            generator.Generate(first, eta.size(), eta.data());
+            for (int n = 0; n < eta.size(); n++) {
+                if (std::abs(eta[n] - expected(first + n, ramp_duration)) > 1e-9) {
+                    std::cerr << "Wrong sample " << first + n << " with ramp " << ramp_duration << ": " << eta[n]
+                              << " instead of " << expected(first + n, ramp_duration) << std::endl;
+                    return 1;
+                }
+            }
+        }
+
+        // sliding window moving forward, then jumping back
+        FreeSurfaceElevationWindow window;
+        for (long long first : {-40LL, -39LL, 0LL, 90LL, 500LL, 10LL}) {
+            const long long last = first + 100;
+            const double* eta    = window.GetSamples(generator, first, last);
+            for (long long n = first; n <= last; n++) {
+                if (std::abs(eta[n - first] - expected(n, ramp_duration)) > 1e-9) {
+                    std::cerr << "Wrong window sample " << n << " with ramp " << ramp_duration << std::endl;
+                    return 1;
+                }
+            }
+        }
+    }
+
+    std::cout << "End" << std::endl;
+    return 0;
+}
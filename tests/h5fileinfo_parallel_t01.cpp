@@ -0,0 +1,109 @@
+#include <hydroc/h5fileinfo.h>
+#include <hydroc/helper.h>
+
+#include <algorithm>
+#include <filesystem>  // C++17
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using std::filesystem::path;
+
+namespace {
+template <int Rank>
+bool SameTensor(const Eigen::Tensor<double, Rank>& a, const Eigen::Tensor<double, Rank>& b) {
+    if (a.dimensions() != b.dimensions()) {
+        return false;
+    }
+    for (Eigen::Index i = 0; i < a.size(); i++) {
+        if (a.data()[i] != b.data()[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Check(bool condition, const std::string& message) {
+    if (!condition) {
+        std::cerr << message << std::endl;
+    }
+    return condition;
+}
+
+std::vector<std::string> GetNames(const std::vector<H5DatasetTiming>& timings) {
+    std::vector<std::string> names;
+    for (const auto& timing : timings) {
+        names.push_back(timing.name);
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+
+    auto h5fname = (DATADIR / "f3of" / "hydroData" / "f3of.h5").lexically_normal().generic_string();
+
+    bool ok = true;
+
+    H5FileInfo sequential_info(h5fname, 3);
+    HydroData sequential = sequential_info.ReadH5Data();
+    H5FileInfo parallel_info(h5fname, 3);
+    parallel_info.SetNumThreads(3);
+    HydroData parallel = parallel_info.ReadH5Data();
+
+    // same data whatever the number of threads
+    for (int b = 0; b < 3; b++) {
+        const auto& seq_body = sequential.GetBodyInfos()[b];
+        const auto& par_body = parallel.GetBodyInfos()[b];
+        ok &= Check(seq_body.body_name == par_body.body_name && seq_body.disp_vol == par_body.disp_vol &&
+                        seq_body.rirf_time_vector == par_body.rirf_time_vector && seq_body.cg == par_body.cg &&
+                        seq_body.cb == par_body.cb && seq_body.lin_matrix == par_body.lin_matrix &&
+                        seq_body.inf_added_mass == par_body.inf_added_mass &&
+                        SameTensor(seq_body.rirf_matrix, par_body.rirf_matrix),
+                    "body data differs");
+        const auto& seq_reg = sequential.GetRegularWaveInfos()[b];
+        const auto& par_reg = parallel.GetRegularWaveInfos()[b];
+        ok &= Check(seq_reg.freq_list == par_reg.freq_list &&
+                        SameTensor(seq_reg.excitation_mag_matrix, par_reg.excitation_mag_matrix) &&
+                        SameTensor(seq_reg.excitation_phase_matrix, par_reg.excitation_phase_matrix),
+                    "regular wave data differs");
+        const auto& seq_irreg = sequential.GetIrregularWaveInfos()[b];
+        const auto& par_irreg = parallel.GetIrregularWaveInfos()[b];
+        ok &= Check(seq_irreg.excitation_re_matrix == par_irreg.excitation_re_matrix &&
+                        seq_irreg.excitation_im_matrix == par_irreg.excitation_im_matrix &&
+                        seq_irreg.excitation_irf_time == par_irreg.excitation_irf_time &&
+                        seq_irreg.excitation_irf_matrix == par_irreg.excitation_irf_matrix,
+                    "irregular wave data differs");
+    }
+
+    // one timing per dataset read
+    const auto& timings = parallel_info.GetDatasetTimings();
+    ok &= Check(!timings.empty() && GetNames(timings) == GetNames(sequential_info.GetDatasetTimings()),
+                "dataset timings differ");
+    for (const auto& timing : timings) {
+        ok &= Check(timing.read_ms >= 0.0 && timing.process_ms >= 0.0, "negative dataset timing");
+        if (timing.name == "body1/hydro_coeffs/radiation_damping/impulse_response_fun/K") {
+            const auto& rirf = sequential.GetBodyInfos()[0].rirf_matrix;
+            ok &= Check(timing.num_values == static_cast<std::size_t>(rirf.size()), "wrong number of values");
+        }
+    }
+
+    try {
+        parallel_info.SetNumThreads(-1);
+        ok &= Check(false, "negative number of threads accepted");
+    } catch (const std::invalid_argument&) {
+    }
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "End" << std::endl;
+    return 0;
+}
@@ -0,0 +1,46 @@
+#include <hydroc/harmonic_synthesis.h>
+
+#include <cmath>
+#include <complex>
+#include <iostream>
+
+int main(int argc, char* argv[]) {
+    // spacing and time step not commensurate, several blocks, offset start time
+    const int num_frequencies = 37;
+    const double omega_0      = 0.013;
+    const double d_omega      = 0.0517;
+    const double dt           = 0.0123;
+    const double t_0          = -3.7;
+    const int num_samples     = 1000;
+
+    Eigen::MatrixXcd coefficients(num_frequencies, 2);
+    for (int k = 0; k < num_frequencies; k++) {
+        coefficients(k, 0) = std::polar(1.0 / (1.0 + k), 0.7 * k);
+        coefficients(k, 1) = std::complex<double>(std::sin(0.3 * k), std::cos(1.1 * k));
+    }
+
+    HarmonicSynthesis synthesis(num_frequencies, omega_0, d_omega, dt);
+    Eigen::MatrixXd series = synthesis.Synthesize(coefficients, t_0, num_samples);
+    if (synthesis.GetBlockSize() >= num_samples) {
+        std::cerr << "Test does not cover several blocks" << std::endl;
+        return 1;
+    }
+
+    for (int n = 0; n < num_samples; n++) {
+        const double t = t_0 + n * dt;
+        for (int c = 0; c < 2; c++) {
+            double expected = 0.0;
+            for (int k = 0; k < num_frequencies; k++) {
+                expected += (coefficients(k, c) * std::polar(1.0, (omega_0 + k * d_omega) * t)).real();
+            }
+            if (std::abs(series(n, c) - expected) > 1e-10) {
+                std::cerr << "Wrong sample " << n << " of series " << c << ": " << series(n, c) << ", expected "
+                          << expected << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    std::cout << "End" << std::endl;
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <hydroc/h5fileinfo.h>
+#include <hydroc/helper.h>
+#include <hydroc/hydro_data_cache.h>
+#include <hydroc/hydro_database.h>
+
+#include <chrono>
+#include <filesystem>  // C++17
+#include <iostream>
+#include <memory>
+#include <string>
+
+using std::filesystem::path;
+
+namespace {
+bool Check(bool condition, const std::string& message) {
+    if (!condition) {
+        std::cerr << message << std::endl;
+    }
+    return condition;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+
+    // a copy of the h5 file, modified below
+    const path h5_source = (DATADIR / "rm3" / "hydroData" / "rm3.h5").lexically_normal();
+    const path h5_copy   = std::filesystem::temp_directory_path() / "hydro_data_cache_t01.h5";
+    std::filesystem::copy_file(h5_source, h5_copy, std::filesystem::copy_options::overwrite_existing);
+    const auto h5fname = h5_copy.generic_string();
+
+    bool ok = true;
+    HydroDataCache::Clear();
+
+    // one load per file and number of bodies
+    auto decay   = HydroDataCache::Get(h5fname, 2, HydroDataRequirements());
+    auto decay_2 = HydroDataCache::Get(h5fname, 2, HydroDataRequirements());
+    auto single  = HydroDataCache::Get(h5fname, 1, HydroDataRequirements());
+    ok &= Check(decay != nullptr && decay == decay_2, "data not shared");
+    ok &= Check(single != decay && single->GetBodyInfos().size() == 1, "number of bodies not in the key");
+    ok &= Check(HydroDataCache::GetSize() == 2, "wrong number of entries");
+
+    // more groups required: replaced, the previous data untouched
+    auto waves = HydroDataCache::Get(h5fname, 2);
+    ok &= Check(waves != decay && waves->GetLoadedRequirements().regular_excitation &&
+                    !decay->GetLoadedRequirements().regular_excitation,
+                "entry not completed for the required groups");
+    ok &= Check(HydroDataCache::Get(h5fname, 2, HydroDataRequirements()) == waves, "complete entry not reused");
+    ok &= Check(waves->GetInfAddedMassMatrix(1) == decay->GetInfAddedMassMatrix(1) &&
+                    waves->GetRIRFVal(1, 2, 8, 10) == decay->GetRIRFVal(1, 2, 8, 10),
+                "shared data differs");
+
+    // modified file read again
+    std::filesystem::last_write_time(h5_copy,
+                                     std::filesystem::last_write_time(h5_copy) + std::chrono::seconds(10));
+    auto modified = HydroDataCache::Get(h5fname, 2);
+    ok &= Check(modified != waves, "modified file not read again");
+
+    // hydro databases are cached the same way
+    const auto db_file = (std::filesystem::temp_directory_path() / "hydro_data_cache_t01.hydrodb").generic_string();
+    HydroDatabase::Write(db_file, *modified);
+    auto db = HydroDataCache::Get(db_file, 2);
+    ok &= Check(db->GetBodyInfos()[0].rirf_mapped != nullptr && db == HydroDataCache::Get(db_file, 2),
+                "hydro database not cached");
+
+    // data in use outlives the cache
+    HydroDataCache::Clear();
+    ok &= Check(HydroDataCache::GetSize() == 0, "cache not cleared");
+    ok &= Check(db->GetRIRFVal(1, 2, 8, 10) == decay->GetRIRFVal(1, 2, 8, 10), "cleared data not usable");
+    ok &= Check(HydroDataCache::Get(h5fname, 2) != modified, "cleared entry reused");
+    HydroDataCache::Clear();
+
+    std::filesystem::remove(h5_copy);
+    std::filesystem::remove(db_file);
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "End" << std::endl;
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include <hydroc/h5fileinfo.h>
+#include <hydroc/helper.h>
+#include <hydroc/wave_types.h>
+
+#include <cstdlib>
+#include <filesystem>  // C++17
+#include <iostream>
+#include <string>
+
+using std::filesystem::path;
+
+namespace {
+bool SameTensor(const Eigen::Tensor<double, 3>& a, const Eigen::Tensor<double, 3>& b) {
+    if (a.dimensions() != b.dimensions()) {
+        return false;
+    }
+    for (Eigen::Index i = 0; i < a.size(); i++) {
+        if (a.data()[i] != b.data()[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Check(bool condition, const std::string& message) {
+    if (!condition) {
+        std::cerr << message << std::endl;
+    }
+    return condition;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+
+    auto h5fname = (DATADIR / "rm3" / "hydroData" / "rm3.h5").lexically_normal().generic_string();
+
+    HydroData full = H5FileInfo(h5fname, 2).ReadH5Data();
+    HydroData lazy = H5FileInfo(h5fname, 2).ReadH5Data(HydroDataRequirements());
+
+    bool ok = true;
+
+    // what each wave model asks for
+    IrregularWaveParams params;
+    params.num_bodies_ = 2;
+    IrregularWaves time_domain(params);
+    params.excitation_mode_ = ExcitationMode::frequencyDomain;
+    IrregularWaves frequency_domain(params);
+    const auto no_wave   = NoWave(2).GetHydroDataRequirements();
+    const auto regular   = RegularWave(2).GetHydroDataRequirements();
+    const auto irf       = time_domain.GetHydroDataRequirements();
+    const auto frequency = frequency_domain.GetHydroDataRequirements();
+    ok &= Check(!no_wave.regular_excitation && !no_wave.irregular_excitation && !no_wave.excitation_irf,
+                "NoWave requires excitation data");
+    ok &= Check(regular.regular_excitation && !regular.irregular_excitation && !regular.excitation_irf,
+                "RegularWave requirements");
+    ok &= Check(!irf.regular_excitation && !irf.irregular_excitation && irf.excitation_irf,
+                "IrregularWaves time domain requirements");
+    ok &= Check(!frequency.regular_excitation && frequency.irregular_excitation && !frequency.excitation_irf,
+                "IrregularWaves frequency domain requirements");
+
+    // no excitation data read, the rest as usual
+    ok &= Check(lazy.GetInfAddedMassMatrix(1) == full.GetInfAddedMassMatrix(1), "added mass differs");
+    ok &= Check(lazy.GetRIRFVal(1, 2, 8, 10) == full.GetRIRFVal(1, 2, 8, 10), "RIRF differs");
+    for (int b = 0; b < 2; b++) {
+        ok &= Check(lazy.GetRegularWaveInfos()[b].excitation_mag_matrix.size() == 0 &&
+                        lazy.GetIrregularWaveInfos()[b].excitation_re_matrix.size() == 0 &&
+                        lazy.GetIrregularWaveInfos()[b].excitation_irf_matrix.size() == 0,
+                    "excitation data read without being required");
+    }
+
+    // each group on demand, the others untouched
+    lazy.Require(regular);
+    for (int b = 0; b < 2; b++) {
+        const auto& lazy_reg = lazy.GetRegularWaveInfos()[b];
+        const auto& full_reg = full.GetRegularWaveInfos()[b];
+        ok &= Check(lazy_reg.freq_list == full_reg.freq_list &&
+                        SameTensor(lazy_reg.excitation_mag_matrix, full_reg.excitation_mag_matrix) &&
+                        SameTensor(lazy_reg.excitation_phase_matrix, full_reg.excitation_phase_matrix),
+                    "regular wave data differs");
+        ok &= Check(lazy.GetIrregularWaveInfos()[b].excitation_irf_matrix.size() == 0,
+                    "excitation IRF read for regular waves");
+    }
+
+    lazy.Require(irf);
+    lazy.Require(frequency);
+    const auto& loaded = lazy.GetLoadedRequirements();
+    ok &= Check(loaded.regular_excitation && loaded.irregular_excitation && loaded.excitation_irf,
+                "loaded requirements not recorded");
+    for (int b = 0; b < 2; b++) {
+        const auto& lazy_irreg = lazy.GetIrregularWaveInfos()[b];
+        const auto& full_irreg = full.GetIrregularWaveInfos()[b];
+        ok &= Check(lazy_irreg.freq_list == full_irreg.freq_list &&
+                        lazy_irreg.excitation_re_matrix == full_irreg.excitation_re_matrix &&
+                        lazy_irreg.excitation_im_matrix == full_irreg.excitation_im_matrix &&
+                        lazy_irreg.excitation_irf_time == full_irreg.excitation_irf_time &&
+                        lazy_irreg.excitation_irf_matrix == full_irreg.excitation_irf_matrix,
+                    "irregular wave data differs");
+    }
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "End" << std::endl;
+    return 0;
+}
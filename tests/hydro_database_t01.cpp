@@ -0,0 +1,152 @@
+#include <hydroc/h5fileinfo.h>
+#include <hydroc/helper.h>
+#include <hydroc/hydro_database.h>
+
+#include <filesystem>  // C++17
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using std::filesystem::path;
+
+namespace {
+template <int Rank>
+bool SameTensor(const Eigen::Tensor<double, Rank>& a, const Eigen::Tensor<double, Rank>& b) {
+    if (a.dimensions() != b.dimensions()) {
+        return false;
+    }
+    for (Eigen::Index i = 0; i < a.size(); i++) {
+        if (a.data()[i] != b.data()[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Check(bool condition, const std::string& message) {
+    if (!condition) {
+        std::cerr << message << std::endl;
+    }
+    return condition;
+}
+
+std::vector<char> ReadBytes(const std::string& file_name) {
+    std::ifstream file(file_name, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// every value of the database matches the h5 data
+bool SameData(HydroData& h5, HydroData& db, int num_bodies) {
+    bool ok = true;
+    ok &= Check(h5.GetRhoVal() == db.GetRhoVal() &&
+                    h5.GetSimulationInfo().g == db.GetSimulationInfo().g &&
+                    h5.GetSimulationInfo().water_depth == db.GetSimulationInfo().water_depth &&
+                    h5.GetSimulationInfo().h5_file_name == db.GetSimulationInfo().h5_file_name,
+                "simulation parameters differ");
+    for (int i = 0; i < 3; i++) {
+        ok &= Check(h5.GetRIRFDims(i) == db.GetRIRFDims(i), "RIRF dimensions differ");
+    }
+    ok &= Check(h5.GetRIRFTimeVector() == db.GetRIRFTimeVector(), "RIRF time vector differs");
+    ok &= Check(h5.HasRadiationStateSpace() == db.HasRadiationStateSpace(), "state space availability differs");
+    for (int b = 0; b < num_bodies; b++) {
+        const auto& h5_body = h5.GetBodyInfos()[b];
+        const auto& db_body = db.GetBodyInfos()[b];
+        ok &= Check(h5_body.body_name == db_body.body_name && h5_body.body_num == db_body.body_num &&
+                        h5_body.disp_vol == db_body.disp_vol && h5_body.rirf_timestep == db_body.rirf_timestep &&
+                        h5_body.cg == db_body.cg && h5_body.cb == db_body.cb &&
+                        h5_body.lin_matrix == db_body.lin_matrix && h5_body.inf_added_mass == db_body.inf_added_mass,
+                    "body properties differ");
+        ok &= Check(db_body.rirf_mapped != nullptr && db_body.rirf_matrix.size() == 0, "RIRF is not mapped");
+        for (int dof = 0; dof < h5.GetRIRFDims(0); dof++) {
+            for (int col = 0; col < h5.GetRIRFDims(1); col++) {
+                for (int s = 0; s < h5.GetRIRFDims(2); s++) {
+                    if (h5.GetRIRFVal(b, dof, col, s) != db.GetRIRFVal(b, dof, col, s)) {
+                        return Check(false, "RIRF differs");
+                    }
+                }
+            }
+        }
+        if (h5_body.rirf_state_space.has_value() && db_body.rirf_state_space.has_value()) {
+            const auto& h5_ss = *h5_body.rirf_state_space;
+            const auto& db_ss = *db_body.rirf_state_space;
+            ok &= Check(SameTensor(h5_ss.A, db_ss.A) && SameTensor(h5_ss.B, db_ss.B) && SameTensor(h5_ss.C, db_ss.C) &&
+                            h5_ss.D == db_ss.D && h5_ss.order == db_ss.order,
+                        "state space differs");
+        }
+
+        const auto& h5_reg = h5.GetRegularWaveInfos()[b];
+        const auto& db_reg = db.GetRegularWaveInfos()[b];
+        ok &= Check(h5_reg.freq_list == db_reg.freq_list &&
+                        SameTensor(h5_reg.excitation_mag_matrix, db_reg.excitation_mag_matrix) &&
+                        SameTensor(h5_reg.excitation_phase_matrix, db_reg.excitation_phase_matrix),
+                    "regular wave data differs");
+        const auto& h5_irreg = h5.GetIrregularWaveInfos()[b];
+        const auto& db_irreg = db.GetIrregularWaveInfos()[b];
+        ok &= Check(h5_irreg.freq_list == db_irreg.freq_list &&
+                        h5_irreg.excitation_re_matrix == db_irreg.excitation_re_matrix &&
+                        h5_irreg.excitation_im_matrix == db_irreg.excitation_im_matrix &&
+                        h5_irreg.excitation_irf_time == db_irreg.excitation_irf_time &&
+                        h5_irreg.excitation_irf_matrix == db_irreg.excitation_irf_matrix,
+                    "irregular wave data differs");
+    }
+    return ok;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+
+    auto h5fname       = (DATADIR / "rm3" / "hydroData" / "rm3.h5").lexically_normal().generic_string();
+    const path tmp_dir = std::filesystem::temp_directory_path();
+    const auto db_file = (tmp_dir / "hydro_database_t01.hydrodb").generic_string();
+    const auto copy    = (tmp_dir / "hydro_database_t01_copy.hydrodb").generic_string();
+
+    bool ok = true;
+
+    // full database
+    HydroData h5 = H5FileInfo(h5fname, 2).ReadH5Data();
+    HydroDatabase::Write(db_file, h5);
+    ok &= Check(HydroDatabase::IsDatabase(db_file) && !HydroDatabase::IsDatabase(h5fname), "database not detected");
+    HydroData db = HydroDatabase::Read(db_file, 2);
+    ok &= Check(SameData(h5, db, 2), "database differs from the h5 file");
+
+    // copies keep the mapping, written again unchanged
+    HydroDatabase::Write(copy, HydroData(db));
+    ok &= Check(ReadBytes(copy) == ReadBytes(db_file), "database written from a database differs");
+
+    // without the excitation data, read from the h5 file on demand
+    HydroDatabase::Write(db_file, H5FileInfo(h5fname, 2).ReadH5Data(HydroDataRequirements()));
+    HydroData lazy = HydroDatabase::Read(db_file, 2);
+    ok &= Check(lazy.GetRegularWaveInfos()[0].excitation_mag_matrix.size() == 0, "excitation data in lazy database");
+    lazy.Require(HydroDataRequirements::All());
+    ok &= Check(SameData(h5, lazy, 2), "lazy database differs from the h5 file");
+
+    // wrong number of bodies, truncated file
+    try {
+        HydroDatabase::Read(copy, 1);
+        ok &= Check(false, "wrong number of bodies accepted");
+    } catch (const std::invalid_argument&) {
+    }
+    std::filesystem::resize_file(copy, std::filesystem::file_size(copy) - 8);
+    try {
+        HydroDatabase::Read(copy, 2);
+        ok &= Check(false, "truncated database accepted");
+    } catch (const std::runtime_error&) {
+    }
+
+    std::filesystem::remove(db_file);
+    std::filesystem::remove(copy);
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "End" << std::endl;
+    return 0;
+}
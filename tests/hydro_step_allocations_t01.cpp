@@ -0,0 +1,236 @@
+#include <hydroc/chloadhydroforces.h>
+#include <hydroc/helper.h>
+#include <hydroc/hydro_forces.h>
+
+#include <chrono/physics/ChSystemNSC.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>  // C++17
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+using std::filesystem::path;
+
+// heap allocations made while counting is on: every operator new, and with glibc every malloc as well, since Eigen
+// allocates its dynamic matrices with malloc
+namespace {
+bool counting        = false;
+long num_allocations = 0;
+
+void* CountedAllocation(std::size_t size) {
+    if (counting) {
+        num_allocations++;
+    }
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+}  // namespace
+
+void* operator new(std::size_t size) {
+    return CountedAllocation(size);
+}
+
+void* operator new[](std::size_t size) {
+    return CountedAllocation(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+#ifdef __GLIBC__
+extern "C" {
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* p, std::size_t size);
+
+void* malloc(std::size_t size) {
+    if (counting) {
+        num_allocations++;
+    }
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size) {
+    if (counting) {
+        num_allocations++;
+    }
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* p, std::size_t size) {
+    if (counting) {
+        num_allocations++;
+    }
+    return __libc_realloc(p, size);
+}
+}
+#endif
+
+namespace {
+const double kTimestep    = 0.01;
+const int kWarmupSteps    = 600;
+const int kCountedSteps   = 600;
+const double kFloatHeave  = -0.72;
+const double kPlateHeave  = -21.29;
+const double kMotionOmega = 0.6;
+const double kMotionHeave = 0.5;
+const double kMotionAngle = 0.02;
+const int kIterations     = 3;  // load evaluations per step, as by the iterations of an implicit integrator
+
+std::shared_ptr<ChBody> AddBody(ChSystem& system, const std::string& name, double z, double mass) {
+    auto body = chrono_types::make_shared<ChBody>();
+    system.Add(body);
+    body->SetNameString(name);
+    body->SetPos(ChVector<>(0, 0, z));
+    body->SetMass(mass);
+    return body;
+}
+
+/**
+ * Runs the RM3 hydro load on a prescribed heave and roll motion of both bodies, stepping the time by hand, and returns
+ * the number of allocations made by the load evaluations after the warm-up steps (-1 for wrong forces). Each step
+ * evaluates the load for the states of the motion, then for slightly different states within the same step, which
+ * the implicit options follow.
+ */
+long CountStepAllocations(const std::string& h5fname,
+                          RadiationMode mode,
+                          bool implicit,
+                          std::shared_ptr<WaveBase> waves) {
+    ChSystemNSC system;
+    system.Set_G_acc(ChVector<>(0.0, 0.0, -9.81));
+    system.SetStep(kTimestep);
+
+    std::vector<std::shared_ptr<ChBody>> bodies;
+    bodies.push_back(AddBody(system, "body1", kFloatHeave, 725834));
+    bodies.push_back(AddBody(system, "body2", kPlateHeave, 886691));
+
+    TestHydro hydro_forces(bodies, h5fname, waves);
+    RadiationParams params;
+    params.mode_ = mode;
+    hydro_forces.SetRadiationParams(params);
+    hydro_forces.SetImplicitHydrostatics(implicit);
+    hydro_forces.SetImplicitRadiation(implicit);
+
+    std::vector<std::shared_ptr<ChLoadable>> loadables(bodies.begin(), bodies.end());
+    ChLoadHydroForces load(&hydro_forces, loadables);
+    ChState state_x(14, nullptr);
+    ChStateDelta state_w(12, nullptr);
+
+    double checksum = 0.0;
+    for (int step = 0; step < kWarmupSteps + kCountedSteps; step++) {
+        const double t = step * kTimestep;
+        system.SetChTime(t);
+        for (int b = 0; b < 2; b++) {
+            const double z0 = (b == 0) ? kFloatHeave : kPlateHeave;
+            const double s  = std::sin(kMotionOmega * t + b);
+            const double c  = std::cos(kMotionOmega * t + b);
+            bodies[b]->SetPos(ChVector<>(0, 0, z0 + kMotionHeave * s));
+            bodies[b]->SetRot(Q_from_AngX(kMotionAngle * s));
+            bodies[b]->SetPos_dt(ChVector<>(0, 0, kMotionOmega * kMotionHeave * c));
+            bodies[b]->SetWvel_par(ChVector<>(kMotionOmega * kMotionAngle * c, 0, 0));
+        }
+
+        counting = step >= kWarmupSteps;
+        for (int iteration = 0; iteration < kIterations; iteration++) {
+            for (int b = 0; b < 2; b++) {
+                const auto pos  = bodies[b]->GetPos();
+                const auto rot  = bodies[b]->GetRot();
+                const auto vel  = bodies[b]->GetPos_dt();
+                const auto wvel = bodies[b]->GetWvel_loc();
+                for (int ii = 0; ii < 3; ii++) {
+                    state_x(7 * b + ii)     = pos[ii];
+                    state_w(6 * b + ii)     = vel[ii] * (1.0 + 0.01 * iteration);
+                    state_w(6 * b + ii + 3) = wvel[ii] * (1.0 + 0.01 * iteration);
+                }
+                state_x(7 * b + 2) += 1e-3 * iteration;
+                for (int ii = 0; ii < 4; ii++) {
+                    state_x(7 * b + 3 + ii) = rot[ii];
+                }
+            }
+            load.ComputeQ(&state_x, &state_w);
+            checksum += load.GetQ().sum();
+        }
+        counting = false;
+    }
+
+    return std::isfinite(checksum) && checksum != 0.0 ? num_allocations : -1;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+
+    auto h5fname = (DATADIR / "rm3" / "hydroData" / "rm3.h5").lexically_normal().generic_string();
+
+    auto regular_wave                     = std::make_shared<RegularWave>(2);
+    regular_wave->regular_wave_amplitude_ = 1.0;
+    regular_wave->regular_wave_omega_     = 2.1;
+
+    IrregularWaveParams wave_params;
+    wave_params.num_bodies_          = 2;
+    wave_params.simulation_dt_       = kTimestep;
+    wave_params.simulation_duration_ = (kWarmupSteps + kCountedSteps) * kTimestep;
+    wave_params.ramp_duration_       = 2.0;
+    wave_params.wave_height_         = 2.0;
+    wave_params.wave_period_         = 8.0;
+    wave_params.nfrequencies_        = 200;
+
+    struct Case {
+        std::string name;
+        RadiationMode mode;
+        bool implicit;
+        std::shared_ptr<WaveBase> waves;
+    };
+    const std::vector<Case> cases = {
+        {"convolution, no waves", RadiationMode::convolution, false, std::make_shared<NoWave>(2)},
+        {"convolution, regular waves", RadiationMode::convolution, false, regular_wave},
+        {"convolution, irregular waves", RadiationMode::convolution, false,
+         std::make_shared<IrregularWaves>(wave_params)},
+        {"fixed step convolution", RadiationMode::convolutionFixedStep, false, std::make_shared<NoWave>(2)},
+        {"FFT convolution", RadiationMode::convolutionFFT, false, std::make_shared<NoWave>(2)},
+        {"implicit convolution, irregular waves", RadiationMode::convolution, true,
+         std::make_shared<IrregularWaves>(wave_params)},
+        {"implicit fixed step convolution", RadiationMode::convolutionFixedStep, true, std::make_shared<NoWave>(2)}};
+
+    bool ok = true;
+    for (const auto& test_case : cases) {
+        num_allocations        = 0;
+        const long allocations = CountStepAllocations(h5fname, test_case.mode, test_case.implicit, test_case.waves);
+        std::cout << test_case.name << ": " << allocations << " allocations in " << kCountedSteps << " steps"
+                  << std::endl;
+        if (allocations != 0) {
+            std::cerr << "Hydro force evaluation allocates (" << test_case.name << ")" << std::endl;
+            ok = false;
+        }
+    }
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "End" << std::endl;
+    return 0;
+}
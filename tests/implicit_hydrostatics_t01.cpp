@@ -0,0 +1,127 @@
+#include <hydroc/chloadaddedmass.h>
+#include <hydroc/helper.h>
+#include <hydroc/hydro_forces.h>
+
+#include <chrono/physics/ChSystemNSC.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>  // C++17
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using std::filesystem::path;
+
+namespace {
+struct HydroModel {
+    ChSystemNSC system;
+    std::vector<std::shared_ptr<ChBody>> bodies;
+    std::unique_ptr<TestHydro> hydro_forces;
+};
+
+// RM3 float and plate
+void SetUp(HydroModel& model, const std::string& h5fname) {
+    model.system.Set_G_acc(ChVector<>(0.0, 0.0, -9.81));
+    model.system.SetStep(0.01);
+    for (int b = 0; b < 2; b++) {
+        auto body = chrono_types::make_shared<ChBody>();
+        model.system.Add(body);
+        body->SetNameString("body" + std::to_string(b + 1));
+        model.bodies.push_back(body);
+    }
+    model.hydro_forces = std::make_unique<TestHydro>(model.bodies, h5fname, std::make_shared<NoWave>(2));
+}
+
+// K Jacobian of the added mass load, 12 x 12
+ChMatrixDynamic<double> GetStiffness(TestHydro& hydro_forces) {
+    auto load = hydro_forces.GetAddedMassLoad();
+    load->CreateJacobianMatrices();
+    ChState state_x(14, nullptr);
+    ChStateDelta state_w(12, nullptr);
+    auto jacobians = load->GetJacobians();
+    load->ComputeJacobian(&state_x, &state_w, jacobians->K, jacobians->R, jacobians->M);
+    return jacobians->K;
+}
+
+bool Check(bool condition, const std::string& message) {
+    if (!condition) {
+        std::cerr << message << std::endl;
+    }
+    return condition;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+
+    auto h5fname = (DATADIR / "rm3" / "hydroData" / "rm3.h5").lexically_normal().generic_string();
+
+    HydroModel model;
+    SetUp(model, h5fname);
+    auto& hydro_forces = *model.hydro_forces;
+
+    // displaced, rotated and moving states
+    Eigen::VectorXd positions(12);
+    Eigen::VectorXd velocities(12);
+    for (int i = 0; i < 12; i++) {
+        positions[i]  = 0.1 * std::sin(1.0 + i);
+        velocities[i] = 0.2 * std::cos(2.0 + i);
+    }
+    positions[2] -= 0.72;
+    positions[8] -= 21.29;
+
+    bool ok = true;
+
+    // explicit by default: the force of the first evaluation is kept for the whole step, no stiffness
+    ok &= Check(!hydro_forces.GetImplicitHydrostatics(), "implicit hydrostatics by default");
+    model.system.SetChTime(1.0);
+    const std::vector<double> first = hydro_forces.ComputeTotalForce(positions, velocities);
+    Eigen::VectorXd displaced       = positions + Eigen::VectorXd::Constant(12, 0.01);
+    ok &= Check(hydro_forces.ComputeTotalForce(displaced, velocities) == first, "explicit force updated in the step");
+    ok &= Check(GetStiffness(hydro_forces).isZero(), "stiffness of the explicit hydrostatics");
+
+    // implicit: K = -dQ/dx, by central differences of the force re-evaluated within a step
+    hydro_forces.SetImplicitHydrostatics(true);
+    model.system.SetChTime(1.01);
+    const std::vector<double> start         = hydro_forces.ComputeTotalForce(positions, velocities);
+    const ChMatrixDynamic<double> stiffness = GetStiffness(hydro_forces);
+    const double h                          = 1e-3;
+    ChMatrixDynamic<double> difference(12, 12);
+    for (int col = 0; col < 12; col++) {
+        displaced = positions;
+        displaced[col] += h;
+        const std::vector<double> plus = hydro_forces.ComputeTotalForce(displaced, velocities);
+        displaced[col] -= 2.0 * h;
+        const std::vector<double> minus = hydro_forces.ComputeTotalForce(displaced, velocities);
+        for (int row = 0; row < 12; row++) {
+            difference(row, col) = -(plus[row] - minus[row]) / (2.0 * h);
+        }
+    }
+    const double max_stiffness = stiffness.cwiseAbs().maxCoeff();
+    const double max_error     = (stiffness - difference).cwiseAbs().maxCoeff();
+    ok &= Check(max_stiffness > 0.0 && max_error <= 1e-6 * max_stiffness,
+                "K Jacobian differs from the finite differences by " + std::to_string(max_error) + ", max stiffness " +
+                    std::to_string(max_stiffness));
+
+    // back at the first positions of the step: the force of the first evaluation
+    const auto& restored   = hydro_forces.ComputeTotalForce(positions, velocities);
+    double max_force       = 0.0;
+    double max_force_error = 0.0;
+    for (int i = 0; i < 12; i++) {
+        max_force       = std::max(max_force, std::abs(start[i]));
+        max_force_error = std::max(max_force_error, std::abs(restored[i] - start[i]));
+    }
+    ok &= Check(max_force_error <= 1e-9 * max_force, "force not restored with the positions");
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "End" << std::endl;
+    return 0;
+}
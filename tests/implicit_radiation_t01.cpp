@@ -0,0 +1,175 @@
+#include <hydroc/chloadaddedmass.h>
+#include <hydroc/helper.h>
+#include <hydroc/hydro_data_cache.h>
+#include <hydroc/hydro_forces.h>
+
+#include <chrono/physics/ChSystemNSC.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>  // C++17
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using std::filesystem::path;
+
+namespace {
+struct HydroModel {
+    ChSystemNSC system;
+    std::vector<std::shared_ptr<ChBody>> bodies;
+    std::unique_ptr<TestHydro> hydro_forces;
+};
+
+// RM3 float and plate, stepped at the RIRF time step of rm3.h5
+void SetUp(HydroModel& model, std::shared_ptr<const HydroData> hydro_data, bool implicit) {
+    model.system.Set_G_acc(ChVector<>(0.0, 0.0, -9.81));
+    model.system.SetStep(0.01);
+    for (int b = 0; b < 2; b++) {
+        auto body = chrono_types::make_shared<ChBody>();
+        model.system.Add(body);
+        body->SetNameString("body" + std::to_string(b + 1));
+        model.bodies.push_back(body);
+    }
+    model.hydro_forces = std::make_unique<TestHydro>(model.bodies, hydro_data, std::make_shared<NoWave>(2));
+    if (implicit) {
+        model.hydro_forces->SetImplicitRadiation(true);
+    }
+}
+
+// R Jacobian of the added mass load, 12 x 12
+ChMatrixDynamic<double> GetDamping(TestHydro& hydro_forces) {
+    auto load = hydro_forces.GetAddedMassLoad();
+    load->CreateJacobianMatrices();
+    ChState state_x(14, nullptr);
+    ChStateDelta state_w(12, nullptr);
+    auto jacobians = load->GetJacobians();
+    load->ComputeJacobian(&state_x, &state_w, jacobians->K, jacobians->R, jacobians->M);
+    return jacobians->R;
+}
+
+Eigen::VectorXd GetVelocities(double time) {
+    Eigen::VectorXd velocities(12);
+    for (int i = 0; i < 12; i++) {
+        velocities[i] = 0.3 * std::sin(0.5 * time + i) + 0.1 * std::cos(1.7 * time - i);
+    }
+    return velocities;
+}
+
+bool Check(bool condition, const std::string& message) {
+    if (!condition) {
+        std::cerr << message << std::endl;
+    }
+    return condition;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+
+    auto h5fname = (DATADIR / "rm3" / "hydroData" / "rm3.h5").lexically_normal().generic_string();
+
+    auto hydro_data = HydroDataCache::Get(h5fname, 2, HydroDataRequirements());
+
+    // trapezoidal integration widths of the RIRF steps
+    const Eigen::VectorXd rirf_time = hydro_data->GetRIRFTimeVector();
+    const int size                  = rirf_time.size();
+    Eigen::VectorXd width           = Eigen::VectorXd::Zero(size);
+    for (int step = 0; step < size; step++) {
+        if (step < size - 1) {
+            width[step] += 0.5 * (rirf_time[step + 1] - rirf_time[step]);
+        }
+        if (step > 0) {
+            width[step] += 0.5 * (rirf_time[step] - rirf_time[step - 1]);
+        }
+    }
+
+    bool ok = true;
+
+    HydroModel at_rest;
+    SetUp(at_rest, hydro_data, false);
+    HydroModel explicit_model;
+    SetUp(explicit_model, hydro_data, false);
+    HydroModel implicit_model;
+    SetUp(implicit_model, hydro_data, true);
+
+    // explicit by default, without damping in the R Jacobian
+    ok &= Check(!at_rest.hydro_forces->GetImplicitRadiation(), "implicit radiation by default");
+    ok &= Check(GetDamping(*explicit_model.hydro_forces).isZero(), "damping of the explicit radiation");
+
+    // R = rho K(0) width[0]
+    const ChMatrixDynamic<double> damping = GetDamping(*implicit_model.hydro_forces);
+    ChMatrixDynamic<double> expected_damping(12, 12);
+    for (int row = 0; row < 12; row++) {
+        for (int col = 0; col < 12; col++) {
+            expected_damping(row, col) = hydro_data->GetRIRFVal(row / 6, row % 6, col, 0) * width[0];
+        }
+    }
+    const double max_damping = expected_damping.cwiseAbs().maxCoeff();
+    ok &= Check(max_damping > 0.0 && (damping - expected_damping).cwiseAbs().maxCoeff() <= 1e-12 * max_damping,
+                "R Jacobian differs from rho K(0) width[0]");
+
+    // radiation force with the lag 0 split out against the convolution over the whole velocity history, no force from
+    // the first sample alone (explicit) or its instantaneous damping only (implicit)
+    const double dt     = 0.01;
+    const int num_steps = 300;
+    std::vector<Eigen::VectorXd> history;
+    const Eigen::VectorXd positions = Eigen::VectorXd::Zero(12);
+    double max_radiation            = 0.0;
+    double max_error                = 0.0;
+    for (int n = 0; n < num_steps; n++) {
+        const double time = n * dt;
+        history.push_back(GetVelocities(time));
+
+        Eigen::VectorXd baseline = Eigen::VectorXd::Zero(12);
+        for (int step = 0; n > 0 && step <= std::min(n, size - 1); step++) {
+            for (int row = 0; row < 12; row++) {
+                for (int col = 0; col < 12; col++) {
+                    baseline[row] += hydro_data->GetRIRFVal(row / 6, row % 6, col, step) * width[step] *
+                                     history[n - step][col];
+                }
+            }
+        }
+        const Eigen::VectorXd implicit_baseline = n > 0 ? baseline : expected_damping * history[n];
+
+        at_rest.system.SetChTime(time);
+        explicit_model.system.SetChTime(time);
+        implicit_model.system.SetChTime(time);
+        const auto& hydrostatics   = at_rest.hydro_forces->ComputeTotalForce(positions, Eigen::VectorXd::Zero(12));
+        const auto& explicit_force = explicit_model.hydro_forces->ComputeTotalForce(positions, history[n]);
+        const auto& implicit_force = implicit_model.hydro_forces->ComputeTotalForce(positions, history[n]);
+        for (int i = 0; i < 12; i++) {
+            max_radiation = std::max(max_radiation, std::abs(baseline[i]));
+            max_error     = std::max({max_error, std::abs(hydrostatics[i] - explicit_force[i] - baseline[i]),
+                                      std::abs(hydrostatics[i] - implicit_force[i] - implicit_baseline[i])});
+        }
+    }
+    ok &= Check(max_radiation > 0.0 && max_error <= 1e-9 * max_radiation,
+                "radiation force differs from the convolution by " + std::to_string(max_error) + ", max force " +
+                    std::to_string(max_radiation));
+
+    // within a step, only the implicit damping follows the velocities
+    const Eigen::VectorXd& last_step        = history.back();
+    const std::vector<double> explicit_first = explicit_model.hydro_forces->ComputeTotalForce(positions, last_step);
+    const std::vector<double> implicit_first = implicit_model.hydro_forces->ComputeTotalForce(positions, last_step);
+    const Eigen::VectorXd velocities         = 2.0 * last_step;
+    ok &= Check(explicit_model.hydro_forces->ComputeTotalForce(positions, velocities) == explicit_first,
+                "explicit radiation updated in the step");
+    const auto& implicit_force   = implicit_model.hydro_forces->ComputeTotalForce(positions, velocities);
+    const Eigen::VectorXd change = -damping * (velocities - last_step);
+    for (int i = 0; i < 12; i++) {
+        ok &= Check(std::abs(implicit_force[i] - implicit_first[i] - change[i]) <= 1e-9 * max_radiation,
+                    "implicit radiation not updated for the velocities of the step");
+    }
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "End" << std::endl;
+    return 0;
+}
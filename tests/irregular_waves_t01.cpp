@@ -0,0 +1,169 @@
+#include <hydroc/h5fileinfo.h>
+#include <hydroc/helper.h>
+#include <hydroc/wave_types.h>
+
+#include <cmath>
+#include <filesystem>  // C++17
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+
+using std::filesystem::path;
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+
+    auto h5fname = (DATADIR / "sphere" / "hydroData" / "sphere.h5").lexically_normal().generic_string();
+
+    HydroData infos = H5FileInfo(h5fname, 1).ReadH5Data();
+    auto wave_infos = infos.GetIrregularWaveInfos();
+    auto sim_infos  = infos.GetSimulationInfo();
+
+    IrregularWaveParams params;
+    params.num_bodies_          = 1;
+    params.simulation_dt_       = 0.015;
+    params.simulation_duration_ = 100.0;
+    params.ramp_duration_       = 20.0;
+    params.wave_height_         = 2.0;
+    params.wave_period_         = 12.0;
+    params.nfrequencies_        = 1000;
+
+    params.excitation_mode_ = ExcitationMode::convolution;
+    IrregularWaves convolution(params);
+    convolution.AddH5Data(wave_infos, sim_infos);
+
+    params.excitation_mode_ = ExcitationMode::precomputed;
+    IrregularWaves precomputed(params);
+    precomputed.AddH5Data(wave_infos, sim_infos);
+
+    if (convolution.GetExcitationTableMemory() != 0 ||
+        precomputed.GetExcitationTableMemory() != sizeof(double) * 6 * 6667) {
+        std::cerr << "Wrong excitation table size " << precomputed.GetExcitationTableMemory() << std::endl;
+        return 1;
+    }
+
+    // same force on the time steps, linear interpolation in between
+    double max_force = 0.0;
+    double max_error = 0.0;
+    double max_mid   = 0.0;
+    for (int step = 0; step < 6000; step++) {
+        const double t = step * params.simulation_dt_;
+        auto expected  = convolution.GetForceAtTime(t);
+        max_force      = std::max(max_force, expected.cwiseAbs().maxCoeff());
+        max_error      = std::max(max_error, (precomputed.GetForceAtTime(t) - expected).cwiseAbs().maxCoeff());
+
+        const double t_mid = t + 0.5 * params.simulation_dt_;
+        max_mid = std::max(max_mid, (precomputed.GetForceAtTime(t_mid) - convolution.GetForceAtTime(t_mid))
+                                        .cwiseAbs()
+                                        .maxCoeff());
+    }
+    if (max_error > 1e-10 * max_force || max_mid > 1e-3 * max_force) {
+        std::cerr << "Precomputed excitation differs from the convolution: " << max_error << " on steps, " << max_mid
+                  << " between steps, max force " << max_force << std::endl;
+        return 1;
+    }
+
+    // the elevation is generated on demand, the convolution is defined after the simulation duration too
+    const double t_after = 3.0 * params.simulation_duration_;
+    if (!convolution.GetForceAtTime(t_after).allFinite() || !precomputed.GetForceAtTime(t_after).allFinite()) {
+        std::cerr << "Wrong excitation force after the simulation duration" << std::endl;
+        return 1;
+    }
+
+    // same sea state synthesized from the excitation coefficients, the ramp applies to the force instead of the
+    // elevation, so the forces are compared once the ramp is over
+    params.excitation_mode_ = ExcitationMode::frequencyDomain;
+    IrregularWaves frequency_domain(params);
+    frequency_domain.AddH5Data(wave_infos, sim_infos);
+    if (frequency_domain.GetExcitationTableMemory() != sizeof(double) * 6 * 6667 ||
+        frequency_domain.GetForceAtTime(0.0).norm() != 0.0) {
+        std::cerr << "Wrong frequency domain excitation table" << std::endl;
+        return 1;
+    }
+    double max_difference = 0.0;
+    for (int step = 3000; step < 6000; step++) {
+        const double t = step * params.simulation_dt_;
+        max_difference =
+            std::max(max_difference, (frequency_domain.GetForceAtTime(t) - precomputed.GetForceAtTime(t)).norm());
+    }
+    if (max_difference > 1e-2 * max_force) {
+        std::cerr << "Frequency domain excitation differs from the convolution by " << max_difference
+                  << ", max force " << max_force << std::endl;
+        return 1;
+    }
+
+    // the second run with the same sea state reads the table from the cache
+    const auto cache_dir = std::filesystem::temp_directory_path() / "hydrochrono_irregular_waves_t01";
+    std::filesystem::remove_all(cache_dir);
+    params.excitation_mode_ = ExcitationMode::precomputed;
+    params.cache_dir_       = cache_dir.generic_string();
+    IrregularWaves first_run(params);
+    first_run.AddH5Data(wave_infos, sim_infos);
+    IrregularWaves second_run(params);
+    second_run.AddH5Data(wave_infos, sim_infos);
+    params.seed_ = 2;
+    IrregularWaves other_seed(params);
+    other_seed.AddH5Data(wave_infos, sim_infos);
+    const int num_entries = std::distance(std::filesystem::directory_iterator(cache_dir), {});
+    std::filesystem::remove_all(cache_dir);
+    if (num_entries != 2) {
+        std::cerr << "Expected 2 cache files, found " << num_entries << std::endl;
+        return 1;
+    }
+    for (int step = 0; step < 6000; step += 7) {
+        const double t = step * params.simulation_dt_;
+        if (second_run.GetForceAtTime(t) != precomputed.GetForceAtTime(t) ||
+            first_run.GetForceAtTime(t) != precomputed.GetForceAtTime(t)) {
+            std::cerr << "Cached excitation differs at time " << t << std::endl;
+            return 1;
+        }
+    }
+
+    // eta file of 50 s: zero elevation only pads the IRF span at the ends of the record, no force past its end
+    const auto eta_file = (std::filesystem::temp_directory_path() / "hydrochrono_irregular_waves_t01_eta.txt");
+    {
+        std::ofstream eta(eta_file);
+        eta.precision(17);
+        for (int i = 0; i <= 5000; i++) {
+            eta << 0.01 * i << " : " << std::sin(0.5 * 0.01 * i) << "\n";
+        }
+    }
+    params.eta_file_path_       = eta_file.generic_string();
+    params.ramp_duration_       = 0.0;
+    params.simulation_duration_ = 50.0;
+    params.excitation_mode_     = ExcitationMode::convolution;
+    IrregularWaves eta_convolution(params);
+    eta_convolution.AddH5Data(wave_infos, sim_infos);
+    params.excitation_mode_ = ExcitationMode::precomputed;
+    IrregularWaves eta_precomputed(params);
+    eta_precomputed.AddH5Data(wave_infos, sim_infos);
+    bool eta_ok = eta_convolution.GetForceAtTime(50.0).allFinite() &&
+                  eta_convolution.GetForceAtTime(50.0 + params.simulation_dt_).allFinite() &&
+                  eta_precomputed.GetForceAtTime(1000 * params.simulation_dt_) ==
+                      eta_convolution.GetForceAtTime(1000 * params.simulation_dt_);
+    try {
+        eta_convolution.GetForceAtTime(60.0);
+        eta_ok = false;
+    } catch (const std::runtime_error&) {
+    }
+    params.simulation_duration_ = 100.0;
+    try {
+        IrregularWaves too_long(params);
+        too_long.AddH5Data(wave_infos, sim_infos);
+        eta_ok = false;
+    } catch (const std::runtime_error&) {
+    }
+    std::filesystem::remove(eta_file);
+    if (!eta_ok) {
+        std::cerr << "Wrong excitation force at the end of the eta file" << std::endl;
+        return 1;
+    }
+
+    std::cout << "End" << std::endl;
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <hydroc/radiation_convolution.h>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    const int num_dofs = 18;  // 3 bodies, the last row block is partly filled
+    const int size     = 50;
+
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> kernel(num_dofs, num_dofs * size);
+    for (int row = 0; row < num_dofs; row++) {
+        for (int col = 0; col < num_dofs; col++) {
+            for (int step = 0; step < size; step++) {
+                kernel(row, col * size + step) = std::exp(-0.05 * step) * std::cos(0.2 * step + row - col);
+            }
+        }
+    }
+
+    // sparse coupling: each force DoF sees the velocity DoFs of the same parity, and the first block is dense
+    std::vector<std::vector<int>> coupling(num_dofs);
+    for (int row = 0; row < num_dofs; row++) {
+        for (int col = 0; col < num_dofs; col++) {
+            if (row < kRadiationRowBlock || (row + col) % 2 == 0) {
+                coupling[row].push_back(col);
+            }
+        }
+    }
+
+    // all lags, and a shorter window as at the start of a simulation
+    for (int num_lags : {size, 17}) {
+        Eigen::MatrixXd velocities(num_lags, num_dofs);
+        for (int step = 0; step < num_lags; step++) {
+            for (int col = 0; col < num_dofs; col++) {
+                velocities(step, col) = std::sin(0.1 * step * (col + 1));
+            }
+        }
+
+        Eigen::VectorXd expected        = Eigen::VectorXd::Constant(num_dofs, 1.0);
+        Eigen::VectorXd expected_sparse = Eigen::VectorXd::Constant(num_dofs, 1.0);
+        for (int row = 0; row < num_dofs; row++) {
+            for (int col = 0; col < num_dofs; col++) {
+                for (int step = 0; step < num_lags; step++) {
+                    expected[row] += kernel(row, col * size + step) * velocities(step, col);
+                }
+            }
+            for (int col : coupling[row]) {
+                for (int step = 0; step < num_lags; step++) {
+                    expected_sparse[row] += kernel(row, col * size + step) * velocities(step, col);
+                }
+            }
+        }
+
+        for (int num_threads : {1, 2, 3, 0}) {
+            Eigen::VectorXd force = Eigen::VectorXd::Constant(num_dofs, 1.0);
+            AddRadiationConvolution(kernel, size, velocities, {}, force, num_threads);
+            if ((force - expected).cwiseAbs().maxCoeff() > 1e-12) {
+                std::cerr << "Wrong force with " << num_threads << " threads and " << num_lags << " lags" << std::endl;
+                return 1;
+            }
+
+            force.setConstant(1.0);
+            AddRadiationConvolution(kernel, size, velocities, coupling, force, num_threads);
+            if ((force - expected_sparse).cwiseAbs().maxCoeff() > 1e-12) {
+                std::cerr << "Wrong sparse force with " << num_threads << " threads and " << num_lags << " lags"
+                          << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    std::cout << "End" << std::endl;
+    return 0;
+}
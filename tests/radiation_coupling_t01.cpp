@@ -0,0 +1,63 @@
+#include <hydroc/radiation_coupling.h>
+
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+int main(int argc, char* argv[]) {
+    const int dofs_per_body = 6;
+    const int num_dofs      = 3 * dofs_per_body;
+
+    // body 0 and 1 strongly coupled, body 2 weakly coupled to both, heave/yaw of each body has zero couplings
+    Eigen::MatrixXd norms(num_dofs, num_dofs);
+    for (int row = 0; row < num_dofs; row++) {
+        for (int col = 0; col < num_dofs; col++) {
+            const int row_body = row / dofs_per_body;
+            const int col_body = col / dofs_per_body;
+            double norm        = (row_body == col_body) ? 10.0 : 1.0;
+            if (row_body == 2 || col_body == 2) {
+                norm = (row_body == col_body) ? 10.0 : 1e-4;
+            }
+            if ((row % dofs_per_body == 5) != (col % dofs_per_body == 5)) {
+                norm = 0.0;
+            }
+            norms(row, col) = norm;
+        }
+    }
+
+    // only zero kernels are pruned by default
+    auto map = BuildRadiationCouplingMap(norms, dofs_per_body, 0.0, {});
+    const int zeros = 2 * 5 * 9;
+    if (map.num_kernels != num_dofs * num_dofs || map.num_zero != zeros || map.num_kept != map.num_kernels - zeros ||
+        map.num_negligible != 0 || map.num_uncoupled != 0 || map.num_body_blocks_kept != 9 || map.IsKept(0, 5) ||
+        !map.IsKept(5, 11)) {
+        std::cerr << "Wrong map without tolerance" << std::endl;
+        return 1;
+    }
+
+    // tolerance prunes the couplings of body 2
+    map = BuildRadiationCouplingMap(norms, dofs_per_body, 1e-3, {});
+    if (map.num_negligible != 4 * 5 * 5 + 4 * 1 || map.num_body_blocks_kept != 5 || map.IsKept(12, 0) ||
+        !map.IsKept(12, 12) || std::abs(map.max_pruned_norm - 1e-5) > 1e-12) {
+        std::cerr << "Wrong map with tolerance" << std::endl;
+        return 1;
+    }
+
+    // interaction graph keeps 0-1 only, each body always interacts with itself
+    map = BuildRadiationCouplingMap(norms, dofs_per_body, 0.0, {{1, 0}});
+    if (map.num_uncoupled != 4 * 36 || map.num_body_blocks_kept != 5 || !map.IsKept(0, 6) || !map.IsKept(6, 0) ||
+        map.IsKept(0, 12) || std::abs(map.max_pruned_norm - 1e-5) > 1e-12) {
+        std::cerr << "Wrong map with interaction graph" << std::endl;
+        return 1;
+    }
+
+    try {
+        BuildRadiationCouplingMap(norms, dofs_per_body, 0.0, {{0, 3}});
+        std::cerr << "Body out of range not detected" << std::endl;
+        return 1;
+    } catch (const std::out_of_range&) {
+    }
+
+    std::cout << "End" << std::endl;
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include <hydroc/radiation_fft_convolution.h>
+
+#include <cmath>
+#include <iostream>
+
+int main(int argc, char* argv[]) {
+    const int num_dofs = 3;
+    const int size     = 100;  // not a multiple of the block size, last partition is partly empty
+    const double dt    = 0.1;
+
+    // kernels with different decay and one zero kernel
+    RadiationFFTConvolution::RowMajorMatrix kernel(num_dofs, num_dofs * size);
+    for (int row = 0; row < num_dofs; row++) {
+        for (int col = 0; col < num_dofs; col++) {
+            for (int step = 0; step < size; step++) {
+                double value                   = std::exp(-0.02 * (row + 1) * step) * std::cos(0.3 * step + col);
+                kernel(row, col * size + step) = (row == 2 && col == 0) ? 0.0 : value;
+            }
+        }
+    }
+
+    for (int block_size : {0, 8, 128}) {
+        RadiationFFTConvolution convolution;
+        convolution.Initialize(kernel, num_dofs, dt, block_size);
+
+        // compare with the direct convolution, velocities are zero before the first step
+        const int num_steps = 350;
+        Eigen::MatrixXd velocities(num_steps, num_dofs);
+        for (int n = 0; n < num_steps; n++) {
+            for (int col = 0; col < num_dofs; col++) {
+                velocities(n, col) = std::sin(0.05 * n * (col + 1)) + 0.1 * std::cos(1.3 * n);
+            }
+        }
+
+        for (int n = 0; n < num_steps; n++) {
+            const Eigen::VectorXd& force = convolution.Advance(n * dt, velocities.row(n).transpose());
+            for (int row = 0; row < num_dofs; row++) {
+                double expected = 0.0;
+                for (int col = 0; col < num_dofs; col++) {
+                    for (int step = 0; step < size && step <= n; step++) {
+                        expected += kernel(row, col * size + step) * velocities(n - step, col);
+                    }
+                }
+                if (std::abs(force[row] - expected) > 1e-10) {
+                    std::cerr << "Wrong force with block size " << convolution.GetBlockSize() << " at step " << n
+                              << ", DoF " << row << ": " << force[row] << ", expected " << expected << std::endl;
+                    return 1;
+                }
+            }
+        }
+    }
+
+    std::cout << "End" << std::endl;
+    return 0;
+}
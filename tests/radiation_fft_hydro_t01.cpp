@@ -0,0 +1,112 @@
+#include <hydroc/helper.h>
+#include <hydroc/hydro_forces.h>
+
+#include <chrono/physics/ChSystemNSC.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>  // C++17
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using std::filesystem::path;
+
+namespace {
+struct HydroModel {
+    ChSystemNSC system;
+    std::vector<std::shared_ptr<ChBody>> bodies;
+    std::unique_ptr<TestHydro> hydro_forces;
+};
+
+void SetUp(HydroModel& model, const std::string& h5fname, int num_bodies, RadiationMode mode, double dt,
+           bool implicit) {
+    model.system.Set_G_acc(ChVector<>(0.0, 0.0, -9.81));
+    model.system.SetStep(dt);
+    for (int b = 0; b < num_bodies; b++) {
+        auto body = chrono_types::make_shared<ChBody>();
+        model.system.Add(body);
+        body->SetNameString("body" + std::to_string(b + 1));
+        model.bodies.push_back(body);
+    }
+    model.hydro_forces = std::make_unique<TestHydro>(model.bodies, h5fname, std::make_shared<NoWave>(num_bodies));
+    model.hydro_forces->SetImplicitRadiation(implicit);
+
+    RadiationParams params;
+    params.mode_ = mode;
+    model.hydro_forces->SetRadiationParams(params);
+}
+
+// FFT against fixed step convolution of the same kernel, on prescribed velocities at fixed positions
+bool CompareModes(const std::string& h5fname, int num_bodies, double dt, int num_steps, bool implicit) {
+    HydroModel fixed_step;
+    SetUp(fixed_step, h5fname, num_bodies, RadiationMode::convolutionFixedStep, dt, implicit);
+    HydroModel fft;
+    SetUp(fft, h5fname, num_bodies, RadiationMode::convolutionFFT, dt, implicit);
+    HydroModel at_rest;
+    SetUp(at_rest, h5fname, num_bodies, RadiationMode::convolutionFixedStep, dt, false);
+
+    const int total_dofs                     = 6 * num_bodies;
+    const Eigen::VectorXd positions          = Eigen::VectorXd::Zero(total_dofs);
+    const Eigen::VectorXd at_rest_velocities = Eigen::VectorXd::Zero(total_dofs);
+    Eigen::VectorXd velocities               = Eigen::VectorXd::Zero(total_dofs);
+    double max_radiation                     = 0.0;
+    double max_error                         = 0.0;
+    for (int step = 0; step < num_steps; step++) {
+        const double time = step * dt;
+        for (int i = 0; i < total_dofs; i++) {
+            velocities[i] = 0.5 * std::cos(0.7 * time) * std::cos(0.3 * time + i) + 0.1 * std::sin(2.3 * time);
+        }
+        fixed_step.system.SetChTime(time);
+        fft.system.SetChTime(time);
+        at_rest.system.SetChTime(time);
+        const auto& hydrostatics = at_rest.hydro_forces->ComputeTotalForce(positions, at_rest_velocities);
+        const auto& expected     = fixed_step.hydro_forces->ComputeTotalForce(positions, velocities);
+        const auto& force        = fft.hydro_forces->ComputeTotalForce(positions, velocities);
+        for (int i = 0; i < total_dofs; i++) {
+            max_radiation = std::max(max_radiation, std::abs(expected[i] - hydrostatics[i]));
+            max_error     = std::max(max_error, std::abs(force[i] - expected[i]));
+        }
+
+        // explicitly, no radiation from the first sample alone
+        if (step == 0 && !implicit && force != hydrostatics) {
+            std::cerr << "FFT radiation force from the first sample alone" << std::endl;
+            return false;
+        }
+    }
+    if (max_radiation == 0.0 || max_error > 1e-9 * max_radiation) {
+        std::cerr << h5fname << (implicit ? ", implicit" : ", explicit")
+                  << ": FFT convolution differs from the fixed step convolution by " << max_error
+                  << ", max radiation " << max_radiation << std::endl;
+        return false;
+    }
+    return true;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+
+    auto sphere_h5 = (DATADIR / "sphere" / "hydroData" / "sphere.h5").lexically_normal().generic_string();
+    auto rm3_h5    = (DATADIR / "rm3" / "hydroData" / "rm3.h5").lexically_normal().generic_string();
+
+    bool ok = true;
+
+    // past the RIRF of sphere.h5 (15 s at dt = 0.015), so every partition of the FFT contributes
+    ok &= CompareModes(sphere_h5, 1, 0.015, 1400, false);
+    ok &= CompareModes(sphere_h5, 1, 0.015, 1400, true);
+    // two coupled bodies, at a time step other than the RIRF step of rm3.h5
+    ok &= CompareModes(rm3_h5, 2, 0.02, 400, false);
+    ok &= CompareModes(rm3_h5, 2, 0.02, 400, true);
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "End" << std::endl;
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include <hydroc/helper.h>
+#include <hydroc/hydro_forces.h>
+
+#include <chrono/physics/ChSystemNSC.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>  // C++17
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using std::filesystem::path;
+
+namespace {
+struct HydroModel {
+    ChSystemNSC system;
+    std::vector<std::shared_ptr<ChBody>> bodies;
+    std::unique_ptr<TestHydro> hydro_forces;
+};
+
+void SetUp(HydroModel& model, const std::string& h5fname, const RadiationParams& params, double system_step) {
+    model.system.Set_G_acc(ChVector<>(0.0, 0.0, -9.81));
+    model.system.SetStep(system_step);
+    auto body = chrono_types::make_shared<ChBody>();
+    model.system.Add(body);
+    body->SetNameString("body1");
+    model.bodies.push_back(body);
+    model.hydro_forces = std::make_unique<TestHydro>(model.bodies, h5fname);
+    model.hydro_forces->SetRadiationParams(params);
+}
+
+// fixed step convolution against the interpolating convolution over 16.5 s, past the 15 s RIRF of sphere.h5 so the
+// history is trimmed, advancing by dt. The fixed step is the ChSystem step unless timestep is positive
+bool CompareModes(const std::string& h5fname, double dt, double system_step, double timestep, double tolerance) {
+    RadiationParams params;
+    HydroModel reference;
+    SetUp(reference, h5fname, params, system_step);
+    params.mode_     = RadiationMode::convolutionFixedStep;
+    params.timestep_ = timestep;
+    HydroModel fixed_step;
+    SetUp(fixed_step, h5fname, params, system_step);
+    if (fixed_step.hydro_forces->GetRadiationParams().timestep_ != dt) {
+        std::cerr << "Fixed radiation time step " << fixed_step.hydro_forces->GetRadiationParams().timestep_
+                  << ", expected " << dt << std::endl;
+        return false;
+    }
+
+    // fixed positions, so the forces only differ from the hydrostatics of the first step (at rest) by the radiation
+    const int num_steps        = static_cast<int>(std::round(16.5 / dt));
+    Eigen::VectorXd positions  = Eigen::VectorXd::Zero(6);
+    Eigen::VectorXd velocities = Eigen::VectorXd::Zero(6);
+    std::vector<double> hydrostatics;
+    double max_radiation = 0.0;
+    double max_error     = 0.0;
+    for (int step = 0; step < num_steps; step++) {
+        const double time = step * dt;
+        for (int i = 0; i < 6; i++) {
+            velocities[i] = 0.5 * std::sin(0.7 * time) * std::cos(0.3 * time + i) + 0.1 * std::sin(2.3 * time);
+        }
+        reference.system.SetChTime(time);
+        fixed_step.system.SetChTime(time);
+        const auto& expected = reference.hydro_forces->ComputeTotalForce(positions, velocities);
+        const auto& force    = fixed_step.hydro_forces->ComputeTotalForce(positions, velocities);
+        if (step == 0) {
+            hydrostatics = expected;
+        }
+        for (int i = 0; i < 6; i++) {
+            max_radiation = std::max(max_radiation, std::abs(expected[i] - hydrostatics[i]));
+            max_error     = std::max(max_error, std::abs(force[i] - expected[i]));
+        }
+
+        // stored samples read directly from the second step on
+        if (step > 0 && !fixed_step.hydro_forces->IsRadiationHistoryUniform()) {
+            std::cerr << "Fixed step convolution interpolated the history at step " << step << " (dt = " << dt << ")"
+                      << std::endl;
+            return false;
+        }
+        if (reference.hydro_forces->IsRadiationHistoryUniform()) {
+            std::cerr << "Uniform history reported by the interpolating convolution" << std::endl;
+            return false;
+        }
+    }
+    std::cout << "dt = " << dt << ": " << max_error / max_radiation << " from the convolution" << std::endl;
+    if (max_radiation == 0.0 || max_error > tolerance * max_radiation) {
+        std::cerr << "Fixed step convolution differs from the convolution by " << max_error << ", max radiation "
+                  << max_radiation << " (dt = " << dt << ")" << std::endl;
+        return false;
+    }
+    return true;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+
+    auto h5fname = (DATADIR / "sphere" / "hydroData" / "sphere.h5").lexically_normal().generic_string();
+
+    bool ok = true;
+
+    // at the RIRF time step of sphere.h5 the RIRF is not resampled: same force up to round-off
+    ok &= CompareModes(h5fname, 0.015, 0.015, 0.0, 1e-9);
+
+    // other steps: the RIRF is linearly interpolated onto the fixed step, while the convolution interpolates the
+    // velocities onto the RIRF steps, the two agree to the discretization error (about 1e-4)
+    ok &= CompareModes(h5fname, 0.01, 0.01, 0.0, 1e-3);
+    ok &= CompareModes(h5fname, 0.02, 0.02, 0.0, 1e-3);
+
+    // fixed step set in RadiationParams instead of the ChSystem step
+    ok &= CompareModes(h5fname, 0.02, 0.01, 0.02, 1e-3);
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "End" << std::endl;
+    return 0;
+}
@@ -0,0 +1,187 @@
+#include <hydroc/helper.h>
+#include <hydroc/hydro_data_cache.h>
+#include <hydroc/hydro_forces.h>
+
+#include <chrono/physics/ChSystemNSC.h>
+#include <unsupported/Eigen/MatrixFunctions>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>  // C++17
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using std::filesystem::path;
+
+namespace {
+// the RIRF time step of sphere.h5, past the 15 s RIRF
+const double kTimestep = 0.015;
+const int kNumSteps    = 1400;
+
+struct HydroModel {
+    ChSystemNSC system;
+    std::vector<std::shared_ptr<ChBody>> bodies;
+    std::unique_ptr<TestHydro> hydro_forces;
+};
+
+std::vector<Eigen::VectorXd> GetVelocities() {
+    std::vector<Eigen::VectorXd> velocities(kNumSteps, Eigen::VectorXd(6));
+    for (int n = 0; n < kNumSteps; n++) {
+        const double time = n * kTimestep;
+        for (int i = 0; i < 6; i++) {
+            velocities[n][i] = 0.5 * std::sin(0.7 * time) * std::cos(0.3 * time + i) + 0.1 * std::sin(1.9 * time);
+        }
+    }
+    return velocities;
+}
+
+// radiation forces of a TestHydro mode on the prescribed velocities, from rest at fixed positions
+std::vector<Eigen::VectorXd> GetRadiationForces(std::shared_ptr<const HydroData> hydro_data,
+                                                RadiationMode mode,
+                                                const std::vector<Eigen::VectorXd>& velocities) {
+    HydroModel model;
+    model.system.Set_G_acc(ChVector<>(0.0, 0.0, -9.81));
+    model.system.SetStep(kTimestep);
+    auto body = chrono_types::make_shared<ChBody>();
+    model.system.Add(body);
+    body->SetNameString("body1");
+    model.bodies.push_back(body);
+    model.hydro_forces = std::make_unique<TestHydro>(model.bodies, hydro_data);
+
+    RadiationParams params;
+    params.mode_ = mode;
+    model.hydro_forces->SetRadiationParams(params);
+
+    // the forces only differ from the hydrostatics of the first step, at rest, by the radiation
+    const Eigen::VectorXd positions = Eigen::VectorXd::Zero(6);
+    std::vector<Eigen::VectorXd> forces(kNumSteps, Eigen::VectorXd(6));
+    std::vector<double> hydrostatics;
+    for (int n = 0; n < kNumSteps; n++) {
+        model.system.SetChTime(n * kTimestep);
+        const auto& force = model.hydro_forces->ComputeTotalForce(positions, velocities[n]);
+        if (n == 0) {
+            hydrostatics = force;
+        }
+        for (int i = 0; i < 6; i++) {
+            forces[n][i] = hydrostatics[i] - force[i];
+        }
+    }
+    return forces;
+}
+
+// trapezoidal convolution of sampled kernels, 6 x 6 for each RIRF step, with the velocity history
+std::vector<Eigen::VectorXd> Convolve(const std::vector<Eigen::MatrixXd>& kernels,
+                                      const std::vector<Eigen::VectorXd>& velocities) {
+    const int size = kernels.size();
+    std::vector<Eigen::VectorXd> forces(kNumSteps, Eigen::VectorXd::Zero(6));
+    for (int n = 1; n < kNumSteps; n++) {
+        for (int step = 0; step <= std::min(n, size - 1); step++) {
+            const double width = (step == 0 || step == size - 1) ? 0.5 * kTimestep : kTimestep;
+            forces[n] += width * kernels[step] * velocities[n - step];
+        }
+    }
+    return forces;
+}
+
+double GetRelativeError(const std::vector<Eigen::VectorXd>& forces, const std::vector<Eigen::VectorXd>& expected) {
+    double max_force = 0.0;
+    double max_error = 0.0;
+    for (int n = 0; n < kNumSteps; n++) {
+        max_force = std::max(max_force, expected[n].cwiseAbs().maxCoeff());
+        max_error = std::max(max_error, (forces[n] - expected[n]).cwiseAbs().maxCoeff());
+    }
+    return max_force > 0.0 ? max_error / max_force : 1.0;
+}
+
+bool Check(bool condition, const std::string& message) {
+    if (!condition) {
+        std::cerr << message << std::endl;
+    }
+    return condition;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+
+    auto h5fname = (DATADIR / "sphere" / "hydroData" / "sphere.h5").lexically_normal().generic_string();
+
+    auto hydro_data = HydroDataCache::Get(h5fname, 1, HydroDataRequirements());
+
+    // the RIRF, and the impulse response C exp(A t) B of its state space realization in the h5 file
+    const int size = hydro_data->GetRIRFDims(2);
+    std::vector<Eigen::MatrixXd> rirf(size, Eigen::MatrixXd::Zero(6, 6));
+    std::vector<Eigen::MatrixXd> realization(size, Eigen::MatrixXd::Zero(6, 6));
+    Eigen::MatrixXd feedthrough = Eigen::MatrixXd::Zero(6, 6);
+    const auto& ss              = hydro_data->GetRadiationStateSpace(0);
+    for (int dof = 0; dof < 6; dof++) {
+        for (int col = 0; col < 6; col++) {
+            for (int step = 0; step < size; step++) {
+                rirf[step](dof, col) = hydro_data->GetRIRFVal(0, dof, col, step);
+            }
+            feedthrough(dof, col) = ss.D(dof, col);
+            const int order       = ss.order(dof, col);
+            if (order <= 0) {
+                continue;
+            }
+            Eigen::MatrixXd A(order, order);
+            Eigen::VectorXd B(order);
+            Eigen::RowVectorXd C(order);
+            for (int ii = 0; ii < order; ii++) {
+                for (int jj = 0; jj < order; jj++) {
+                    A(ii, jj) = ss.A(dof, col, ii, jj);
+                }
+                B[ii] = ss.B(dof, col, ii, 0);
+                C[ii] = ss.C(dof, col, 0, ii);
+            }
+            const Eigen::MatrixXd transition = (A * kTimestep).exp();
+            Eigen::VectorXd states           = B;
+            for (int step = 0; step < size; step++) {
+                realization[step](dof, col) = C * states;
+                states                      = transition * states;
+            }
+        }
+    }
+
+    const std::vector<Eigen::VectorXd> velocities   = GetVelocities();
+    std::vector<Eigen::VectorXd> realization_forces = Convolve(realization, velocities);
+    for (int n = 0; n < kNumSteps; n++) {
+        realization_forces[n] += feedthrough * velocities[n];
+    }
+    const std::vector<Eigen::VectorXd> rirf_forces = Convolve(rirf, velocities);
+
+    bool ok = true;
+
+    const auto convolution = GetRadiationForces(hydro_data, RadiationMode::convolution, velocities);
+    ok &= Check(GetRelativeError(convolution, rirf_forces) <= 1e-9, "convolution differs from the RIRF convolution");
+
+    // the realization of sphere.h5 (second order models of the kernels) is itself some way from the RIRF: the state
+    // space force matches the convolution of its impulse response, and the convolution within that error
+    const double realization_error = GetRelativeError(realization_forces, rirf_forces);
+    const auto state_space         = GetRadiationForces(hydro_data, RadiationMode::stateSpace, velocities);
+    const double discretization    = GetRelativeError(state_space, realization_forces);
+    const double state_space_error = GetRelativeError(state_space, convolution);
+    std::cout << "state space: " << state_space_error << " from the convolution, realization error "
+              << realization_error << ", " << discretization << " from the realization" << std::endl;
+    ok &= Check(discretization <= 1e-3, "state space force differs from the convolution of its realization");
+    ok &= Check(state_space_error <= realization_error + 0.01, "state space force beyond the realization error");
+
+    // each kernel fitted within RadiationParams::fit_tolerance_ (1 %) of the largest one, a few kernels add up in the
+    // force of each DoF
+    const auto fitted      = GetRadiationForces(hydro_data, RadiationMode::stateSpaceFit, velocities);
+    const double fit_error = GetRelativeError(fitted, convolution);
+    std::cout << "fitted state space: " << fit_error << " from the convolution" << std::endl;
+    ok &= Check(fit_error <= 0.05, "fitted state space force beyond the fit error");
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "End" << std::endl;
+    return 0;
+}
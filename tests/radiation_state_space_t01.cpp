@@ -0,0 +1,46 @@
+#include <hydroc/radiation_state_space.h>
+
+#include <cmath>
+#include <iostream>
+
+int main(int argc, char* argv[]) {
+    // kernel K(t) = c * exp(-a * t) from DoF 1 to DoF 0, realized with a single state
+    const double a = 2.0;
+    const double c = 3.0;
+    const double w = 1.5;
+
+    RadiationStateSpace radiation;
+    radiation.Clear(2);
+    radiation.AddKernel(0, 1, Eigen::MatrixXd::Constant(1, 1, -a), Eigen::VectorXd::Ones(1),
+                        Eigen::RowVectorXd::Constant(1, c), 0.0);
+
+    if (radiation.GetNumKernels() != 1 || radiation.GetNumStates() != 1) {
+        std::cerr << "Wrong number of kernels or states" << std::endl;
+        return 1;
+    }
+
+    // velocity sin(w t) starting from rest, the convolution has a closed form (first order hold error is O(dt^2))
+    Eigen::VectorXd velocity = Eigen::VectorXd::Zero(2);
+    const double dt          = 0.01;
+    double max_error         = 0.0;
+    for (int n = 0; n <= 1000; n++) {
+        double t                     = n * dt;
+        velocity[1]                  = std::sin(w * t);
+        const Eigen::VectorXd& force = radiation.Advance(t, velocity);
+
+        double expected = c * (a * std::sin(w * t) - w * std::cos(w * t) + w * std::exp(-a * t)) / (a * a + w * w);
+        max_error       = std::max(max_error, std::abs(force[0] - expected));
+        if (force[1] != 0.0) {
+            std::cerr << "Force in DoF without kernel: " << force[1] << std::endl;
+            return 1;
+        }
+    }
+
+    if (max_error > 1e-4) {
+        std::cerr << "State space radiation error too large: " << max_error << std::endl;
+        return 1;
+    }
+
+    std::cout << "End" << std::endl;
+    return 0;
+}
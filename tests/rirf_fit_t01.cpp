@@ -0,0 +1,50 @@
+#include <hydroc/rirf_fit.h>
+
+#include <unsupported/Eigen/MatrixFunctions>
+
+#include <cmath>
+#include <iostream>
+
+// damped oscillation plus slow decay, exactly a 3 state model
+double Kernel(double t) {
+    return 3.0 * std::exp(-t) * std::cos(2.0 * t) + std::exp(-0.3 * t);
+}
+
+int main(int argc, char* argv[]) {
+    const double dt = 0.02;
+    Eigen::VectorXd samples(1001);
+    for (int step = 0; step < samples.size(); step++) {
+        samples[step] = Kernel(step * dt);
+    }
+
+    auto fit = FitRIRFKernel(samples, dt, 1e-6, 10);
+    if (fit.order != 3 || fit.error > 1e-6) {
+        std::cerr << "Wrong fit: order " << fit.order << ", error " << fit.error << std::endl;
+        return 1;
+    }
+
+    // the continuous model must also match between samples
+    for (double t : {0.01, 0.333, 1.7, 12.345}) {
+        double value = fit.C * (fit.A * t).exp() * fit.B;
+        if (std::abs(value - Kernel(t)) > 1e-5) {
+            std::cerr << "Wrong fitted value at t = " << t << ": " << value << ", expected " << Kernel(t) << std::endl;
+            return 1;
+        }
+    }
+
+    // a loose tolerance must give a lower order
+    auto coarse_fit = FitRIRFKernel(samples, dt, 0.5, 10);
+    if (coarse_fit.order >= fit.order || coarse_fit.error > 0.5) {
+        std::cerr << "Wrong coarse fit: order " << coarse_fit.order << ", error " << coarse_fit.error << std::endl;
+        return 1;
+    }
+
+    // zero kernels do not need any state
+    if (FitRIRFKernel(Eigen::VectorXd::Zero(100), dt, 1e-6, 10).order != 0) {
+        std::cerr << "Zero kernel fitted with states" << std::endl;
+        return 1;
+    }
+
+    std::cout << "End" << std::endl;
+    return 0;
+}
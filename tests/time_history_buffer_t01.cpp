@@ -0,0 +1,48 @@
+#include <hydroc/time_history_buffer.h>
+
+#include <iostream>
+
+int main(int argc, char* argv[]) {
+    const int width = 6;
+    TimeHistoryBuffer history(width, 4);
+
+    Eigen::VectorXd sample(width);
+
+    // push more samples than the initial capacity, dropping the oldest one every other step to wrap around storage
+    int num_pushed = 0;
+    for (int n = 0; n < 20; n++) {
+        sample.setConstant(n);
+        history.Push(0.1 * n, sample);
+        num_pushed++;
+        if (n % 2 == 1) {
+            history.PopOldest();
+        }
+    }
+
+    // newest first, values and times must follow the push order
+    for (int i = 0; i < history.Size(); i++) {
+        int n = num_pushed - 1 - i;
+        if (history.Time(i) != 0.1 * n || history.Value(i, width - 1) != n) {
+            std::cerr << "Wrong sample " << i << ": time " << history.Time(i) << ", value "
+                      << history.Value(i, width - 1) << ", expected " << n << std::endl;
+            return 1;
+        }
+    }
+
+    // the window over all samples must match the samples, even when the storage wraps around
+    auto window = history.Window(history.Size());
+    for (int i = 0; i < history.Size(); i++) {
+        if (window(i, 0) != history.Value(i, 0)) {
+            std::cerr << "Wrong window sample " << i << ": " << window(i, 0) << std::endl;
+            return 1;
+        }
+    }
+
+    if (history.Size() != 10 || history.Capacity() < history.Size()) {
+        std::cerr << "Wrong size " << history.Size() << " or capacity " << history.Capacity() << std::endl;
+        return 1;
+    }
+
+    std::cout << "End" << std::endl;
+    return 0;
+}
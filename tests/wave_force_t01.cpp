@@ -0,0 +1,95 @@
+#include <hydroc/h5fileinfo.h>
+#include <hydroc/helper.h>
+#include <hydroc/wave_types.h>
+
+#include <filesystem>  // C++17
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using std::filesystem::path;
+
+namespace {
+// the buffer and batched queries give the same forces as GetForceAtTime(t), and reject wrongly sized buffers
+bool CheckQueries(WaveBase& waves, const Eigen::VectorXd& times, const std::string& name) {
+    Eigen::MatrixXd batched(12, times.size());
+    waves.GetForceAtTimes(times, batched);
+    Eigen::VectorXd force(12);
+    for (Eigen::Index k = 0; k < times.size(); k++) {
+        const Eigen::VectorXd expected = waves.GetForceAtTime(times[k]);
+        waves.GetForceAtTime(times[k], force);
+        if (force != expected || batched.col(k) != expected) {
+            std::cerr << name << ": forces differ at time " << times[k] << std::endl;
+            return false;
+        }
+    }
+
+    int num_errors = 0;
+    try {
+        Eigen::VectorXd wrong_size(6);
+        waves.GetForceAtTime(0.0, wrong_size);
+    } catch (const std::invalid_argument&) {
+        num_errors++;
+    }
+    try {
+        Eigen::MatrixXd wrong_columns(12, times.size() + 1);
+        waves.GetForceAtTimes(times, wrong_columns);
+    } catch (const std::invalid_argument&) {
+        num_errors++;
+    }
+    if (num_errors != 2) {
+        std::cerr << name << ": wrong buffer sizes accepted" << std::endl;
+        return false;
+    }
+    return true;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (hydroc::SetInitialEnvironment(argc, argv) != 0) {
+        return 1;
+    }
+
+    path DATADIR(hydroc::getDataDir());
+
+    auto h5fname = (DATADIR / "rm3" / "hydroData" / "rm3.h5").lexically_normal().generic_string();
+
+    HydroData infos = H5FileInfo(h5fname, 2).ReadH5Data();
+    auto wave_infos = infos.GetIrregularWaveInfos();
+    auto sim_infos  = infos.GetSimulationInfo();
+
+    // on the time steps, between them, and after the simulation duration
+    Eigen::VectorXd times(6);
+    times << 0.0, 1.0, 12.345, 25.0, 29.9, 45.0;
+
+    NoWave no_wave(2);
+    bool ok = CheckQueries(no_wave, times, "NoWave");
+
+    RegularWave regular(2);
+    regular.regular_wave_amplitude_ = 1.0;
+    regular.regular_wave_omega_     = 2.1;
+    regular.AddH5Data(infos.GetRegularWaveInfos());
+    regular.Initialize();
+    ok = ok && CheckQueries(regular, times, "RegularWave") && regular.GetForceAtTime(1.0).norm() > 0.0;
+
+    IrregularWaveParams params;
+    params.num_bodies_          = 2;
+    params.simulation_dt_       = 0.01;
+    params.simulation_duration_ = 30.0;
+    params.ramp_duration_       = 5.0;
+    params.wave_height_         = 2.0;
+    params.wave_period_         = 8.0;
+    params.nfrequencies_        = 200;
+    for (auto mode : {ExcitationMode::convolution, ExcitationMode::precomputed}) {
+        params.excitation_mode_ = mode;
+        IrregularWaves irregular(params);
+        irregular.AddH5Data(wave_infos, sim_infos);
+        ok = ok && CheckQueries(irregular, times, "IrregularWaves") && irregular.GetForceAtTime(12.345).norm() > 0.0;
+    }
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "End" << std::endl;
+    return 0;
+}
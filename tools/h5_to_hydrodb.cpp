@@ -0,0 +1,36 @@
+#include <hydroc/h5fileinfo.h>
+#include <hydroc/hydro_database.h>
+
+#include <exception>
+#include <filesystem>  // C++17
+#include <iostream>
+#include <string>
+
+// Converts a bemio h5 file to a preprocessed hydro database (see HydroDatabase), loaded by TestHydro in place of the
+// h5 file.
+//
+// usage: ./h5_to_hydrodb H5FILE NUM_BODIES [DATABASE]
+//
+// DATABASE defaults to H5FILE with the .hydrodb extension. Every optional group of datasets is stored.
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 4) {
+        std::cerr << "usage: " << argv[0] << " H5FILE NUM_BODIES [DATABASE]" << std::endl;
+        return 1;
+    }
+    const std::string h5_file_name = argv[1];
+    const std::string db_file_name =
+        argc > 3 ? argv[3] : std::filesystem::path(h5_file_name).replace_extension(".hydrodb").generic_string();
+
+    try {
+        const int num_bodies = std::stoi(argv[2]);
+        HydroDatabase::Write(db_file_name, H5FileInfo(h5_file_name, num_bodies).ReadH5Data());
+        // checks the result the way TestHydro loads it
+        HydroDatabase::Read(db_file_name, num_bodies);
+    } catch (const std::exception& e) {
+        std::cerr << "Conversion failed: " << e.what() << std::endl;
+        return 1;
+    }
+    std::cout << "wrote " << db_file_name << " (" << std::filesystem::file_size(db_file_name) << " bytes)"
+              << std::endl;
+    return 0;
+}